@@ -0,0 +1,11 @@
+// A translation unit that only passes a Tello around, e.g. a mission planner's header
+#include "tello_fwd.h"
+
+struct Mission {
+    Tello& tello;
+    FlipDirection finale;
+};
+
+Tello& drone_of(Mission& mission) {
+    return mission.tello;
+}
@@ -0,0 +1,6 @@
+// Baseline: the whole header-only library in a translation unit that uses a Tello
+#include "tello.h"
+
+bool fly(Tello& tello) {
+    return tello.takeoff() && tello.move_forward(100) && tello.land();
+}
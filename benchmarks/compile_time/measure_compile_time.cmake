@@ -0,0 +1,43 @@
+# Times the compilation of every source in VARIANTS and reports the best of REPEAT runs,
+# relative to the first variant. Driven by the 'compile_time' target:
+#
+#   cmake -DCOMPILER=<c++> -DFLAGS=<flags> -DSOURCE_DIR=<dir> -DVARIANTS=<a.cpp;b.cpp>
+#         -DREPEAT=<n> [-DOUT=<file.json>] -P measure_compile_time.cmake
+
+separate_arguments(flags NATIVE_COMMAND "${FLAGS}")
+
+set(entries)
+set(baseline "")
+foreach(variant IN LISTS VARIANTS)
+    set(best "")
+    foreach(run RANGE 1 ${REPEAT})
+        string(TIMESTAMP start "%s%f")
+        execute_process(
+            COMMAND ${COMPILER} ${flags} ${SOURCE_DIR}/${variant}
+            RESULT_VARIABLE result
+            ERROR_VARIABLE errors)
+        string(TIMESTAMP end "%s%f")
+
+        if(NOT result EQUAL 0)
+            message(FATAL_ERROR "Compiling ${variant} failed:\n${errors}")
+        endif()
+
+        math(EXPR elapsed "(${end} - ${start}) / 1000")
+        if(best STREQUAL "" OR elapsed LESS best)
+            set(best ${elapsed})
+        endif()
+    endforeach()
+
+    if(baseline STREQUAL "")
+        set(baseline ${best})
+    endif()
+    math(EXPR percent "100 * ${best} / ${baseline}")
+    message("${variant}: ${best} ms (${percent}%)")
+
+    list(APPEND entries "    { \"name\": \"compile_time/${variant}\", \"run_type\": \"iteration\", \"iterations\": ${REPEAT}, \"real_time\": ${best}, \"time_unit\": \"ms\" }")
+endforeach()
+
+if(OUT)
+    list(JOIN entries ",\n" benchmarks)
+    file(WRITE ${OUT} "{\n  \"context\": { \"library_name\": \"tello\" },\n  \"benchmarks\": [\n${benchmarks}\n  ]\n}\n")
+endif()
@@ -0,0 +1,7 @@
+// The same translation unit with the larger non-template functions compiled in tello.cpp
+#define TELLO_SEPARATE_COMPILATION
+#include "tello.h"
+
+bool fly(Tello& tello) {
+    return tello.takeoff() && tello.move_forward(100) && tello.land();
+}
@@ -0,0 +1,280 @@
+// Microbenchmarks for the hot paths of tello.h.
+//
+// Usage: tello_benchmarks [--filter <substring>] [--min-time <seconds>] [--out <file.json>]
+//
+// A summary is printed to stdout. With --out, the results are also written as JSON in the format
+// of Google Benchmark, so they can be compared across releases with its tools (e.g. compare.py).
+
+#include "tello.h"
+
+#include <cstdio>
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+#ifndef _WIN32
+#include <time.h>
+#endif
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct Result {
+    std::string name;
+    uint64_t iterations = 0;
+    double mean_ns = 0.0;
+    double cpu_ns = 0.0; // CPU time of the benchmark thread only, like Google Benchmark's cpu_time
+    double p50_ns = 0.0; // Percentiles over the per-batch means
+    double p99_ns = 0.0;
+};
+
+struct Options {
+    std::string filter;
+    std::string out;
+    double min_time_s = 0.5;
+};
+
+template<typename T>
+void do_not_optimize(const T& value) {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    static const volatile void* sink;
+    sink = &value;
+#endif
+}
+
+// CPU time consumed by the calling thread
+double thread_cpu_ns() {
+#ifdef _WIN32
+    FILETIME creation, exit, kernel, user;
+    ::GetThreadTimes(::GetCurrentThread(), &creation, &exit, &kernel, &user);
+    auto ticks = [](const FILETIME& t) { return (static_cast<uint64_t>(t.dwHighDateTime) << 32) | t.dwLowDateTime; };
+    return static_cast<double>(ticks(kernel) + ticks(user)) * 100.0; // 100 ns units
+#else
+    timespec ts{};
+    ::clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return static_cast<double>(ts.tv_sec) * 1e9 + static_cast<double>(ts.tv_nsec);
+#endif
+}
+
+// Runs 'op' in batches of roughly a millisecond until the minimum time has passed
+template<typename F>
+Result run(std::string name, const Options& options, F&& op) {
+    using namespace std::chrono;
+
+    uint64_t batch = 1;
+    while (batch < (uint64_t(1) << 24)) {
+        const auto t0 = Clock::now();
+        for (uint64_t i = 0; i < batch; ++i) op();
+        if (Clock::now() - t0 >= milliseconds(1)) break;
+        batch *= 2;
+    }
+
+    std::vector<double> samples;
+    uint64_t iterations = 0;
+    const auto start = Clock::now();
+    const double cpuStart = thread_cpu_ns();
+    const auto minTime = duration<double>(options.min_time_s);
+    while (Clock::now() - start < minTime || samples.empty()) {
+        const auto t0 = Clock::now();
+        for (uint64_t i = 0; i < batch; ++i) op();
+        const double ns = duration<double, std::nano>(Clock::now() - t0).count();
+        samples.push_back(ns / static_cast<double>(batch));
+        iterations += batch;
+    }
+    const double total_ns = duration<double, std::nano>(Clock::now() - start).count();
+    const double cpu_ns = thread_cpu_ns() - cpuStart;
+
+    std::ranges::sort(samples);
+    auto percentile = [&](double p) { return samples[static_cast<size_t>(p * static_cast<double>(samples.size() - 1))]; };
+
+    Result result;
+    result.name = std::move(name);
+    result.iterations = iterations;
+    result.mean_ns = total_ns / static_cast<double>(iterations);
+    result.cpu_ns = cpu_ns / static_cast<double>(iterations);
+    result.p50_ns = percentile(0.50);
+    result.p99_ns = percentile(0.99);
+    return result;
+}
+
+// Swallows everything written to std::cout, so the Log() output does not distort the measurements
+class NullBuffer : public std::streambuf {
+protected:
+    int overflow(int c) override { return c; }
+    std::streamsize xsputn(const char*, std::streamsize n) override { return n; }
+};
+
+// A typical telemetry packet of a Tello EDU with mission pads enabled
+constexpr std::string_view TELEMETRY_PACKET =
+    "mid:-1;x:0;y:0;z:0;mpry:0,0,0;pitch:1;roll:-2;yaw:37;vgx:3;vgy:0;vgz:-1;templ:83;temph:85;"
+    "tof:112;h:100;bat:87;baro:185.35;time:12;agx:-11.00;agy:4.00;agz:-999.00;\r\n";
+
+// Answers every command of a LoopbackLink with "ok" until destroyed
+class Responder {
+public:
+    explicit Responder(std::shared_ptr<Tello::LoopbackLink> link)
+    : thread([link](std::stop_token st) {
+        while (!st.stop_requested()) {
+            if (auto command = link->poll_command())
+                link->respond(*command == "battery?" ? "87" : "ok");
+            else
+                std::this_thread::yield();
+        }
+    }) {}
+
+private:
+    std::jthread thread;
+};
+
+std::vector<Result> run_all(const Options& options) {
+    std::vector<Result> results;
+    auto bench = [&](std::string name, auto&& op) {
+        if (!options.filter.empty() && name.find(options.filter) == std::string::npos)
+            return;
+        results.push_back(run(std::move(name), options, op));
+        const auto& r = results.back();
+        std::printf("%-40s %14llu %12.1f ns %12.1f ns %12.1f ns %12.1f ns\n", r.name.c_str(),
+            static_cast<unsigned long long>(r.iterations), r.mean_ns, r.cpu_ns, r.p50_ns, r.p99_ns);
+        std::fflush(stdout);
+    };
+
+    std::printf("%-40s %14s %15s %15s %15s %15s\n", "benchmark", "iterations", "mean", "cpu", "p50", "p99");
+
+    // === Telemetry parsing (OnDataStream) ===
+    {
+        auto link = std::make_shared<Tello::LoopbackLink>();
+        Tello tello(std::make_unique<Tello::LoopbackTransport>(link));
+        bench("parse/telemetry_packet", [&] { link->send_telemetry(TELEMETRY_PACKET); });
+
+#ifndef _WIN32
+        if (tello.enable_shared_telemetry("tello_benchmarks", true)) {
+            bench("parse/telemetry_packet_shm_publish", [&] { link->send_telemetry(TELEMETRY_PACKET); });
+            tello.disable_shared_telemetry();
+        }
+#endif
+    }
+
+    // === Command formatting (the std::vformat call of execute_command/execute_action) ===
+    {
+        float distance = 123.f;
+        bench("format/move_forward", [&] {
+            auto command = std::vformat("forward {}", std::make_format_args(distance));
+            do_not_optimize(command);
+        });
+
+        float x1 = 50.f, y1 = 50.f, z1 = 0.f, x2 = 100.f, y2 = 0.f, z2 = 20.f, speed = 40.f;
+        bench("format/curve", [&] {
+            auto command = std::vformat("curve {} {} {} {} {} {} {}", std::make_format_args(x1, y1, z1, x2, y2, z2, speed));
+            do_not_optimize(command);
+        });
+    }
+
+    // === Command round trip through the loopback transport ===
+    {
+        auto link = std::make_shared<Tello::LoopbackLink>();
+        Responder responder(link); // Must outlive the Tello, which lands on destruction
+        Tello tello(std::make_unique<Tello::LoopbackTransport>(link));
+        if (tello.connect("loopback")) {
+            bench("command/loopback_round_trip", [&] { do_not_optimize(tello.set_speed(50.f)); });
+            bench("command/loopback_read_float", [&] { do_not_optimize(tello.get_battery_level()); });
+        }
+    }
+
+    // === UDPsocket send/recv round trip over the loopback interface ===
+    {
+        UDPsocket a, b;
+        uint16_t portA = 0, portB = 0;
+        if (a.open() >= 0 && b.open() >= 0 && a.bind_any(portA) >= 0 && b.bind_any(portB) >= 0) {
+            const auto addrB = UDPsocket::IPv4::Loopback(portB);
+            const std::string request = "forward 100";
+            std::vector<uint8_t> buffer;
+            UDPsocket::IPv4 sender;
+            bench("udp/send_recv_round_trip", [&] {
+                a.send(std::as_bytes(std::span(request)), addrB);
+                b.recv(buffer, sender);
+                b.send(buffer, UDPsocket::IPv4::Loopback(portA));
+                a.recv(buffer, sender);
+            });
+        }
+    }
+
+    // === state() with and without concurrent readers and a telemetry writer ===
+    {
+        auto link = std::make_shared<Tello::LoopbackLink>();
+        Tello tello(std::make_unique<Tello::LoopbackTransport>(link));
+        link->send_telemetry(TELEMETRY_PACKET);
+
+        bench("state/uncontended", [&] { do_not_optimize(tello.state()); });
+
+        std::vector<std::jthread> load;
+        load.emplace_back([&](std::stop_token st) {
+            while (!st.stop_requested()) link->send_telemetry(TELEMETRY_PACKET);
+        });
+        for (int i = 0; i < 3; ++i) {
+            load.emplace_back([&](std::stop_token st) {
+                while (!st.stop_requested()) do_not_optimize(tello.state());
+            });
+        }
+        bench("state/contended_3_readers_1_writer", [&] { do_not_optimize(tello.state()); });
+    }
+
+    // === Logging ===
+    {
+        float battery = 87.f;
+        bench("log/info", [&] { PRINTF_INFO("[Tello] Connected: Battery level {:.0f}%", battery); });
+    }
+
+    return results;
+}
+
+std::string to_json(const std::vector<Result>& results) {
+    std::string json;
+    json += "{\n  \"context\": {\n";
+    json += std::format("    \"unix_time\": {},\n", std::chrono::system_clock::now().time_since_epoch() / std::chrono::seconds(1));
+    json += std::format("    \"num_cpus\": {},\n", std::thread::hardware_concurrency());
+    json += "    \"library_name\": \"tello\"\n  },\n  \"benchmarks\": [\n";
+    for (size_t i = 0; i < results.size(); ++i) {
+        const auto& r = results[i];
+        json += std::format(
+            "    {{ \"name\": \"{}\", \"run_type\": \"iteration\", \"iterations\": {}, \"real_time\": {:.3f}, "
+            "\"cpu_time\": {:.3f}, \"time_unit\": \"ns\", \"p50_ns\": {:.3f}, \"p99_ns\": {:.3f} }}{}\n",
+            r.name, r.iterations, r.mean_ns, r.cpu_ns, r.p50_ns, r.p99_ns, i + 1 < results.size() ? "," : "");
+    }
+    json += "  ]\n}\n";
+    return json;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Options options;
+    for (int i = 1; i < argc; ++i) {
+        const std::string_view arg = argv[i];
+        const bool hasValue = i + 1 < argc;
+        if (arg == "--filter" && hasValue) options.filter = argv[++i];
+        else if (arg == "--out" && hasValue) options.out = argv[++i];
+        else if (arg == "--min-time" && hasValue) options.min_time_s = std::stod(argv[++i]);
+        else {
+            std::fprintf(stderr, "Usage: %s [--filter <substring>] [--min-time <seconds>] [--out <file.json>]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    NullBuffer nullBuffer;
+    auto* coutBuffer = std::cout.rdbuf(&nullBuffer);
+    const auto results = run_all(options);
+    std::cout.rdbuf(coutBuffer);
+
+    if (!options.out.empty()) {
+        std::ofstream file(options.out);
+        file << to_json(results);
+        if (!file) {
+            std::fprintf(stderr, "Failed to write '%s'\n", options.out.c_str());
+            return 1;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,5 @@
+// Compiled implementation of tello.h for builds with TELLO_SEPARATE_COMPILATION.
+// Link exactly one copy of this file into the program.
+
+#define TELLO_IMPLEMENTATION
+#include "tello.h"
@@ -0,0 +1,57 @@
+// Experimental C++20 module interface of tello.h. Build it as a module interface unit, then use:
+//
+//     import tello;
+//
+// Only the API is exported, the PRINTF_* logging macros are not available through the module.
+
+module;
+
+#include "tello.h"
+
+export module tello;
+
+export using ::ByteContainer;
+export using ::UDPsocket;
+
+export using ::LogColor;
+export using ::LogLine;
+export using ::Log;
+
+export using ::FlipDirection;
+export using ::MP_DetectDir;
+export using ::Tello;
+
+export namespace TelloDefaults {
+    using TelloDefaults::IP;
+    using TelloDefaults::COMMAND_PORT;
+    using TelloDefaults::DATA_PORT;
+    using TelloDefaults::LOCAL_PORT;
+    using TelloDefaults::COMMAND_TIMEOUT_MS;
+    using TelloDefaults::ACTION_TIMEOUT_MS;
+    using TelloDefaults::SHM_SLOT_COUNT;
+    using TelloDefaults::SHM_RAW_CAPACITY;
+    using TelloDefaults::SHM_READ_RETRIES;
+    using TelloDefaults::LOOPBACK_QUEUE_SIZE;
+    using TelloDefaults::MAX_PAD_ID;
+    using TelloDefaults::PAD_LOST_MS;
+    using TelloDefaults::TELEMETRY_THREAD_NAME;
+    using TelloDefaults::PREFAULT_STACK_BYTES;
+    using TelloDefaults::ACTION_SPEED_CMPS;
+    using TelloDefaults::ACTION_YAW_RATE_DPS;
+    using TelloDefaults::ACTION_TAKEOFF_HEIGHT_CM;
+    using TelloDefaults::ACTION_TAKEOFF_MS;
+    using TelloDefaults::ACTION_LAND_MS;
+    using TelloDefaults::ACTION_FLIP_MS;
+    using TelloDefaults::ACTION_TIMEOUT_FACTOR;
+    using TelloDefaults::ACTION_TIMEOUT_MARGIN_MS;
+    using TelloDefaults::ACTION_STALL_MS;
+    using TelloDefaults::ACTION_POLL_MS;
+    using TelloDefaults::TELEMETRY_VELOCITY_SCALE;
+    using TelloDefaults::GO_MIN_CM;
+    using TelloDefaults::GO_MAX_CM;
+    using TelloDefaults::SPEED_MIN_CMPS;
+    using TelloDefaults::GO_SPEED_MAX_CMPS;
+    using TelloDefaults::CURVE_SPEED_MAX_CMPS;
+    using TelloDefaults::CURVE_RADIUS_MIN_CM;
+    using TelloDefaults::CURVE_RADIUS_MAX_CM;
+}
@@ -26,7 +26,11 @@
 #include <arpa/inet.h>
 #include <netinet/in.h>
 #include <sys/socket.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
 #include <unistd.h>
+#include <pthread.h>
 #endif
 
 #ifndef INPORT_ANY
@@ -43,15 +47,46 @@
 #include <thread>
 #include <chrono>
 #include <mutex>
+#include <condition_variable>
 #include <functional>
-#include <format>
-#include <iostream>
 #include <charconv>
-#include <ranges>
 #include <span>
 #include <optional>
+#include <atomic>
+#include <memory>
+#include <algorithm>
+#include <cmath>
+#include <bit>
+
+// By default tello.h is header-only. With TELLO_SEPARATE_COMPILATION, the larger non-template
+// functions (connection, path planning, transports, parsing, logging) are only compiled in the
+// translation unit that defines TELLO_IMPLEMENTATION (see tello.cpp), so every other one is
+// spared their code and the headers only they need.
+#if !defined(TELLO_SEPARATE_COMPILATION) || defined(TELLO_IMPLEMENTATION)
+#include <iostream>
+#include <ranges>
+#ifndef _WIN32
+#include <sys/ioctl.h>
+#include <sched.h>
+#include <signal.h>
+#include <cerrno>
+#endif
+#ifdef __linux__
+#include <linux/sockios.h>
+#endif
+#endif
+
+#ifdef TELLO_SEPARATE_COMPILATION
+#define TELLO_INLINE
+#else
+#define TELLO_INLINE inline
+#endif
+
 
 
+// Concepts may only be declared at namespace scope
+template<typename T>
+concept ByteContainer = sizeof(typename T::value_type) == sizeof(uint8_t);
 
 class UDPsocket
 {
@@ -214,9 +249,6 @@ public:
     }
 
 public:
-    template<typename T>
-    concept ByteContainer = sizeof(typename T::value_type) == sizeof(uint8_t);
-
     template <ByteContainer T>
     int send(const T& message, const IPv4& ipaddr) const
     {
@@ -392,27 +424,52 @@ namespace std
 
 
 namespace TelloDefaults {
-    static constexpr std::string_view IP = "192.168.10.1";
-    static constexpr uint16_t COMMAND_PORT = 8889;
-    static constexpr uint16_t DATA_PORT = 8890;
-    static constexpr uint16_t LOCAL_PORT = 36085;
-    static constexpr int COMMAND_TIMEOUT_MS = 1000;
-    static constexpr int ACTION_TIMEOUT_MS = 0; // 0 = forever
+    inline constexpr std::string_view IP = "192.168.10.1";
+    inline constexpr uint16_t COMMAND_PORT = 8889;
+    inline constexpr uint16_t DATA_PORT = 8890;
+    inline constexpr uint16_t LOCAL_PORT = 36085;
+    inline constexpr int COMMAND_TIMEOUT_MS = 1000;
+    inline constexpr int ACTION_TIMEOUT_MS = 0; // 0 = forever
+    inline constexpr uint32_t SHM_SLOT_COUNT = 64;
+    inline constexpr uint32_t SHM_RAW_CAPACITY = 512;
+    inline constexpr int SHM_READ_RETRIES = 1000; // A slot that stays half-written longer than this belongs to a dead publisher
+    inline constexpr size_t LOOPBACK_QUEUE_SIZE = 16;
+    inline constexpr int32_t MAX_PAD_ID = 8;
+    inline constexpr int PAD_LOST_MS = 500; // A pad counts as lost once it has not been reported for this long
+    inline constexpr std::string_view TELEMETRY_THREAD_NAME = "tello-telemetry";
+    inline constexpr size_t PREFAULT_STACK_BYTES = 64 * 1024;
+
+    // Used to estimate how long an action takes, see Tello::set_adaptive_action_timeout()
+    inline constexpr float ACTION_SPEED_CMPS = 100.f; // Assumed until set_speed() is called
+    inline constexpr float ACTION_YAW_RATE_DPS = 60.f;
+    inline constexpr float ACTION_TAKEOFF_HEIGHT_CM = 80.f;
+    inline constexpr int ACTION_TAKEOFF_MS = 5000;
+    inline constexpr int ACTION_LAND_MS = 5000;
+    inline constexpr int ACTION_FLIP_MS = 2000;
+    inline constexpr float ACTION_TIMEOUT_FACTOR = 1.5f;
+    inline constexpr int ACTION_TIMEOUT_MARGIN_MS = 3000;
+    inline constexpr int ACTION_STALL_MS = 3000; // No progress for this long means the action is stuck
+    inline constexpr int ACTION_POLL_MS = 100;
+    inline constexpr float TELEMETRY_VELOCITY_SCALE = 10.f; // vgx/vgy/vgz are reported in dm/s
+
+    // Argument limits of the SDK, respected by Tello::compile_path()
+    inline constexpr float GO_MIN_CM = 20.f;
+    inline constexpr float GO_MAX_CM = 500.f;
+    inline constexpr float SPEED_MIN_CMPS = 10.f;
+    inline constexpr float GO_SPEED_MAX_CMPS = 100.f;
+    inline constexpr float CURVE_SPEED_MAX_CMPS = 60.f;
+    inline constexpr float CURVE_RADIUS_MIN_CM = 50.f;
+    inline constexpr float CURVE_RADIUS_MAX_CM = 1000.f;
 }
 
 // C++20 logging utilities using std::format and ANSI escape codes
 enum class LogColor { Red, Green, Blue, Yellow, White };
 
+// Writes a single colored line to stdout
+TELLO_INLINE void LogLine(LogColor color, std::string_view message);
+
 void Log(LogColor color, std::string_view fmt, auto&&... args) {
-    const char* color_code;
-    switch (color) {
-        case LogColor::Red:    color_code = "1;91"; break;
-        case LogColor::Green:  color_code = "0;92"; break;
-        case LogColor::Blue:   color_code = "1;94"; break;
-        case LogColor::Yellow: color_code = "0;93"; break;
-        default:               color_code = "0;97"; break;
-    }
-    std::cout << std::format("\033[{}m{}\033[m\n", color_code, std::vformat(fmt, std::make_format_args(args...)));
+    LogLine(color, std::vformat(fmt, std::make_format_args(args...)));
 }
 
 #define PRINTF_INFO(...) Log(LogColor::Green, __VA_ARGS__)
@@ -441,19 +498,51 @@ enum class MP_DetectDir {
 
 class Tello {
 
-    class SyncSocket {
+public:
+    // Scheduling of a thread, see configure_threads() and configure_this_thread()
+    struct ThreadConfig {
+        std::string name;              // Empty keeps the current or default name. Linux truncates it to 15 characters.
+        int cpu = -1;                  // Pin the thread to this CPU, -1 = no affinity
+        int realtime_priority = 0;      // SCHED_FIFO priority 1-99, 0 = default scheduling
+        bool prefault = false;         // Touch the stack up front, so it is resident once mlockall() was called
+    };
+
+    // Time from a telemetry packet arriving at the socket to the thread waking up to read it
+    struct ThreadStats {
+        std::string name;
+        uint64_t samples = 0;
+        double mean_us = 0.0;
+        uint64_t max_us = 0;
+        uint64_t p50_us = 0;           // Upper bounds, taken from a power-of-two histogram
+        uint64_t p99_us = 0;
+    };
+
+private:
+    // Lock-free histogram of wakeup latencies, written by a single thread
+    class LatencyRecorder {
     public:
-        SyncSocket(uint16_t sourcePort = 0) {
-            if (socket.open() < 0) {
-                PRINTF_ERROR("SyncSocket::SyncSocket: socket.open() failed.");
-                return;
-            }
-            if (socket.bind(sourcePort) < 0) {
-                PRINTF_ERROR("SyncSocket::SyncSocket: socket.bind() failed. Port {} may be in use.", sourcePort);
-                return;
-            }
+        void record(std::chrono::nanoseconds latency) {
+            const auto us = static_cast<uint64_t>(std::max<int64_t>(0, std::chrono::duration_cast<std::chrono::microseconds>(latency).count()));
+            samples.fetch_add(1, std::memory_order_relaxed);
+            totalUs.fetch_add(us, std::memory_order_relaxed);
+            if (us > maxUs.load(std::memory_order_relaxed))
+                maxUs.store(us, std::memory_order_relaxed);
+            buckets[std::min<size_t>(std::bit_width(us), buckets.size() - 1)].fetch_add(1, std::memory_order_relaxed);
         }
 
+        TELLO_INLINE ThreadStats stats(std::string name) const;
+
+    private:
+        std::atomic<uint64_t> samples{ 0 };
+        std::atomic<uint64_t> totalUs{ 0 };
+        std::atomic<uint64_t> maxUs{ 0 };
+        std::array<std::atomic<uint64_t>, 32> buckets{};
+    };
+
+    class SyncSocket {
+    public:
+        TELLO_INLINE SyncSocket(uint16_t sourcePort = 0);
+
         bool send(std::string_view targetIP, uint16_t targetPort, std::string_view data) {
             UDPsocket::IPv4 ip(targetIP, targetPort);
             return socket.send(std::as_bytes(std::span(data)), ip) >= 0;
@@ -494,22 +583,15 @@ class Tello {
 
     class AsyncSocket {
     public:
-        AsyncSocket(uint16_t port, std::function<void(std::string_view)> cb) 
-        : callback(std::move(cb)) {
-            if (socket.open() < 0) {
-                PRINTF_ERROR("AsyncSocket::AsyncSocket: socket.open() failed.");
-                return;
-            }
-            if (socket.bind(port) < 0) {
-                PRINTF_ERROR("AsyncSocket::AsyncSocket: socket.bind() failed. Port {} may be in use.", port);
-                return;
-            }
-            listener = std::jthread([this](std::stop_token st) { listen(st); });
-        }
+        TELLO_INLINE AsyncSocket(uint16_t port, std::function<void(std::string_view)> cb, const ThreadConfig& config);
 
         ~AsyncSocket() {
             listener.request_stop();
             socket.interrupt(); // Interrupt the blocking recv call
+
+            // Join before any member is destroyed, the listener uses all of them
+            if (listener.joinable())
+                listener.join();
         }
 
         bool send(std::string_view ip, uint16_t port, std::string_view data) {
@@ -517,35 +599,95 @@ class Tello {
             return socket.send(std::as_bytes(std::span(data)), _ip) >= 0;
         }
 
-    private:
-        void listen(std::stop_token st) {
-            while (!st.stop_requested()) {
-                std::vector<uint8_t> buffer;
-                UDPsocket::IPv4 ipaddr;
-                int error = socket.recv(buffer, ipaddr);
+        // Applies to the running listener, a requested prefault happens when it next wakes up
+        bool configure(const ThreadConfig& config) {
+            if (!listener.joinable()) return false;
+            {
+                std::lock_guard lock(nameMTX);
+                if (!config.name.empty()) threadName = config.name;
+            }
+            if (config.prefault) prefaultPending = true;
+            return apply_thread_config(listener.native_handle(), config);
+        }
 
-                if (st.stop_requested()) break;
+        ThreadStats stats() const {
+            std::lock_guard lock(nameMTX);
+            return latency.stats(threadName);
+        }
 
-                if (error < 0) {
-                    PRINTF_ERROR("AsyncSocket::listen: socket.recv() failed: Error code {}", error);
-                    continue;
-                }
+    private:
+        TELLO_INLINE void listen(std::stop_token st);
 
-                if (callback)
-                    callback({reinterpret_cast<const char*>(buffer.data()), buffer.size()});
-            }
-        }
+        TELLO_INLINE void record_latency();
 
     private:
         UDPsocket socket;
         std::jthread listener;
         std::function<void(std::string_view)> callback;
+        LatencyRecorder latency;
+        std::atomic<bool> prefaultPending{ false };
+        mutable std::mutex nameMTX;
+        std::string threadName;
+    };
+
+public:
+    struct TelloState;
+
+    // Last known pose of the drone relative to a mission pad
+    struct PadSighting {
+        int32_t id = 0;
+        int32_t x = 0, y = 0, z = 0; // cm
+        int32_t pitch = 0, roll = 0, yaw = 0;
+        bool visible = false;
+        std::chrono::steady_clock::time_point lastSeen;
+
+        float distance() const { return std::hypot(static_cast<float>(x), static_cast<float>(y), static_cast<float>(z)); }
     };
 
+    enum class PadEvent { Acquired, Lost };
+
+private:
     class MissionPadAPI {
     public:
         MissionPadAPI(Tello* tello) : tello(tello) {}
 
+        // The callback runs on the telemetry thread, long running work should be handed off
+        void on_pad_event(std::function<void(PadEvent, const PadSighting&)> callback) {
+            std::lock_guard lock(padMTX);
+            padCallback = std::move(callback);
+        }
+
+        // The queries count a pad as visible only if it was reported within PAD_LOST_MS,
+        // even if the telemetry stopped before the Lost event could be raised
+        std::optional<PadSighting> get_pad(int32_t mp_id) {
+            std::lock_guard lock(padMTX);
+            if (mp_id < 1 || mp_id > TelloDefaults::MAX_PAD_ID || pads[mp_id].id == 0)
+                return std::nullopt;
+            return current(pads[mp_id], std::chrono::steady_clock::now());
+        }
+
+        // All pads seen since the drone was created
+        std::vector<PadSighting> get_pads() {
+            std::lock_guard lock(padMTX);
+            const auto now = std::chrono::steady_clock::now();
+            std::vector<PadSighting> seen;
+            for (const auto& pad : pads) {
+                if (pad.id != 0) seen.push_back(current(pad, now));
+            }
+            return seen;
+        }
+
+        std::optional<PadSighting> get_nearest_visible_pad() {
+            std::lock_guard lock(padMTX);
+            const auto now = std::chrono::steady_clock::now();
+            const PadSighting* nearest = nullptr;
+            for (const auto& pad : pads) {
+                if (current(pad, now).visible && (!nearest || pad.distance() < nearest->distance()))
+                    nearest = &pad;
+            }
+            return nearest ? std::optional(*nearest) : std::nullopt;
+        }
+
         bool enable_pad_detection() { return tello->execute_command("mon"); }
         bool disable_pad_detection() { return tello->execute_command("moff"); }
         bool set_pad_detection_direction(MP_DetectDir direction) {
@@ -563,13 +705,233 @@ class Tello {
         }
 
     private:
+        friend class Tello;
+
+        // Called for every telemetry packet, fires the events once padMTX is released
+        TELLO_INLINE void update(const TelloState& state);
+
+        static bool expired(const PadSighting& pad, std::chrono::steady_clock::time_point now) {
+            return now - pad.lastSeen > std::chrono::milliseconds(TelloDefaults::PAD_LOST_MS);
+        }
+
+        static PadSighting current(PadSighting pad, std::chrono::steady_clock::time_point now) {
+            pad.visible = pad.visible && !expired(pad, now);
+            return pad;
+        }
+
         Tello* tello;
+        std::mutex padMTX;
+        std::array<PadSighting, TelloDefaults::MAX_PAD_ID + 1> pads{}; // Indexed by pad ID, 0 is unused
+        std::function<void(PadEvent, const PadSighting&)> padCallback;
+    };
+
+    // Lock-free single-producer/single-consumer ring buffer
+    template<typename T, size_t Capacity>
+    class SpscQueue {
+        static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+    public:
+        bool push(T value) {
+            const size_t tail = writeIndex.load(std::memory_order_relaxed);
+            if (tail - readIndex.load(std::memory_order_acquire) == Capacity)
+                return false;
+
+            slots[tail & (Capacity - 1)] = std::move(value);
+            writeIndex.store(tail + 1, std::memory_order_release);
+            return true;
+        }
+
+        std::optional<T> pop() {
+            const size_t head = readIndex.load(std::memory_order_relaxed);
+            if (head == writeIndex.load(std::memory_order_acquire))
+                return std::nullopt;
+
+            T value = std::move(slots[head & (Capacity - 1)]);
+            readIndex.store(head + 1, std::memory_order_release);
+            return value;
+        }
+
+    private:
+        std::array<T, Capacity> slots{};
+        alignas(64) std::atomic<size_t> writeIndex{ 0 };
+        alignas(64) std::atomic<size_t> readIndex{ 0 };
+    };
+
+public:
+
+    // Carries commands to the drone and telemetry back from it
+    class Transport {
+    public:
+        virtual ~Transport() = default;
+
+        virtual bool send(std::string_view ip, std::string_view command) = 0;
+        virtual std::optional<std::string> recv(int timeout_ms) = 0; // 0 = forever
+
+        // Called once by Tello, the callback must be invoked for every telemetry packet
+        virtual void start_telemetry(std::function<void(std::string_view)> callback) = 0;
+
+        // Transports that run their own threads apply the configuration to them and report their latency
+        virtual bool configure_threads(const ThreadConfig&) { return true; }
+        virtual std::vector<ThreadStats> thread_stats() const { return {}; }
+    };
+
+    // The default transport: commands and telemetry over real UDP sockets
+    class UdpTransport : public Transport {
+    public:
+        UdpTransport(
+            uint16_t cmdPort = TelloDefaults::COMMAND_PORT,
+            uint16_t dataPort = TelloDefaults::DATA_PORT,
+            uint16_t locPort = TelloDefaults::LOCAL_PORT) :
+            commandSocket(locPort),
+            commandPort(cmdPort),
+            dataPort(dataPort)
+        {
+            telemetryThread.name = TelloDefaults::TELEMETRY_THREAD_NAME;
+        }
+
+        // The telemetry listener starts with the given scheduling, e.g. to avoid the latency spikes
+        // of it being preempted before configure_threads() could be called
+        TELLO_INLINE UdpTransport(
+            const ThreadConfig& telemetryThread,
+            uint16_t cmdPort = TelloDefaults::COMMAND_PORT,
+            uint16_t dataPort = TelloDefaults::DATA_PORT,
+            uint16_t locPort = TelloDefaults::LOCAL_PORT);
+
+        TELLO_INLINE bool send(std::string_view ip, std::string_view command) override;
+
+        TELLO_INLINE std::optional<std::string> recv(int timeout_ms) override;
+
+        TELLO_INLINE void start_telemetry(std::function<void(std::string_view)> callback) override;
+
+        TELLO_INLINE bool configure_threads(const ThreadConfig& config) override;
+
+        TELLO_INLINE std::vector<ThreadStats> thread_stats() const override;
+
+    private:
+        SyncSocket commandSocket;
+        std::unique_ptr<AsyncSocket> dataSocket;
+        ThreadConfig telemetryThread;
+        uint16_t commandPort = 0;
+        uint16_t dataPort = 0;
+    };
+
+    class LoopbackTransport;
+
+    // The drone's end of a LoopbackTransport. A simulator polls the commands sent by Tello,
+    // answers them and feeds telemetry, all in-process and without sockets.
+    class LoopbackLink {
+    public:
+        std::optional<std::string> poll_command() { return commands.queue.pop(); }
+
+        // Blocks until a command arrives, the timeout expires (0 = forever) or the link is closed
+        std::optional<std::string> wait_command(int timeout_ms = 0) {
+            return wait_pop(commands, timeout_ms);
+        }
+
+        bool respond(std::string_view response) { return push_notify(responses, response); }
+
+        // Ends the simulation: pending and future waits on both ends fail instead of blocking
+        void close() {
+            {
+                std::lock_guard lock(waitMTX);
+                closed = true;
+            }
+            commands.ready.notify_all();
+            responses.ready.notify_all();
+        }
+
+        bool is_closed() const { return closed.load(); }
+
+        // The packet is parsed synchronously on the calling thread. Returns false if no Tello is attached.
+        bool send_telemetry(std::string_view packet) {
+            delivering.fetch_add(1);
+            const bool delivered = attached.load();
+            if (delivered)
+                telemetryCallback(packet);
+            delivering.fetch_sub(1);
+            return delivered;
+        }
+
+    private:
+        friend class Tello::LoopbackTransport;
+
+        void attach(std::function<void(std::string_view)> callback) {
+            telemetryCallback = std::move(callback);
+            attached.store(true);
+        }
+
+        void detach() {
+            attached.store(false);
+            while (delivering.load() != 0)
+                std::this_thread::yield(); // Let a packet that is being parsed finish
+            close();
+        }
+
+        // One direction of the link: the queue itself is lock-free, only waiting for it takes waitMTX
+        struct Channel {
+            SpscQueue<std::string, TelloDefaults::LOOPBACK_QUEUE_SIZE> queue;
+            std::condition_variable ready;
+        };
+
+        bool push_notify(Channel& channel, std::string_view message) {
+            if (!channel.queue.push(std::string(message))) return false;
+            { std::lock_guard lock(waitMTX); } // The waiter is either still checking the queue or already notifiable
+            channel.ready.notify_one();
+            return true;
+        }
+
+        std::optional<std::string> wait_pop(Channel& channel, int timeout_ms) {
+            if (auto message = channel.queue.pop()) return message;
+
+            std::optional<std::string> message;
+            auto ready = [&] { return (message = channel.queue.pop()).has_value() || closed.load(); };
+            std::unique_lock lock(waitMTX);
+            if (timeout_ms > 0)
+                channel.ready.wait_for(lock, std::chrono::milliseconds(timeout_ms), ready);
+            else
+                channel.ready.wait(lock, ready);
+            return message;
+        }
+
+        Channel commands;
+        Channel responses;
+        std::function<void(std::string_view)> telemetryCallback;
+        std::atomic<bool> attached{ false };
+        std::atomic<int> delivering{ 0 };
+        std::atomic<bool> closed{ false };
+        std::mutex waitMTX;
+    };
+
+    // Connects a Tello to a LoopbackLink in the same process, e.g. for simulation and load tests
+    class LoopbackTransport : public Transport {
+    public:
+        LoopbackTransport(std::shared_ptr<LoopbackLink> link) : link(std::move(link)) {}
+
+        ~LoopbackTransport() override {
+            link->detach();
+        }
+
+        bool send(std::string_view, std::string_view command) override {
+            return !link->is_closed() && link->push_notify(link->commands, command);
+        }
+
+        std::optional<std::string> recv(int timeout_ms) override {
+            return link->wait_pop(link->responses, timeout_ms);
+        }
+
+        void start_telemetry(std::function<void(std::string_view)> callback) override {
+            link->attach(std::move(callback));
+        }
+
+    private:
+        std::shared_ptr<LoopbackLink> link;
     };
 
 public:
 
     struct TelloState {
         int32_t mp_id = 0, mp_x = 0, mp_y = 0, mp_z = 0;
+        int32_t mp_pitch = 0, mp_roll = 0, mp_yaw = 0;
         int32_t pitch = 0, roll = 0, yaw = 0;
         int32_t vgx = 0, vgy = 0, vgz = 0;
         int32_t templ = 0, temph = 0;
@@ -579,62 +941,212 @@ public:
         float agx = 0.f, agy = 0.f, agz = 0.f;
     };
 
-public:
-    Tello(
-        uint16_t cmdPort = TelloDefaults::COMMAND_PORT,
-        uint16_t dataPort = TelloDefaults::DATA_PORT,
-        uint16_t locPort = TelloDefaults::LOCAL_PORT) :
-        commandServer(locPort),
-        dataServer(dataPort, [this](auto data) { OnDataStream(data); }),
-        commandPort(cmdPort),
-        missionPadAPI(this)
-    {
-    }
+    struct ActionProgress {
+        std::string command;
+        bool active = false;
+        bool stalled = false;
+        float percent = 0.f;
+        int elapsed_ms = 0;
+        int expected_ms = 0; // 0 if the duration of the action could not be estimated
+    };
+
+    // Coordinates are in cm, in a frame fixed at the pose where the path starts: x forward,
+    // y left and z up, like the 'go' command. The heading is in degrees clockwise from the
+    // initial heading; if set, the drone turns to it after reaching the waypoint.
+    struct Waypoint {
+        float x = 0.f, y = 0.f, z = 0.f;
+        std::optional<float> heading = std::nullopt;
+        bool arc = false; // Fly from the previous waypoint through this one to the next on a single 'curve'
+    };
 
-    ~Tello() {
-        if (connected) {
-            execute_action("land", true);
-            execute_command("streamoff", true);
+    struct PathOptions {
+        float speed_cmps = 50.f;
+        bool allow_arcs = true;    // Fly arcs with 'curve', otherwise every segment is flown with 'go'
+        float tolerance_cm = 1.f;  // Maximum deviation for waypoints to count as collinear or on one circle
+    };
+
+    // A single SDK command produced by compile_path(), in the drone's body frame
+    struct PathStep {
+        enum class Type { Go, Curve, TurnRight, TurnLeft };
+        Type type = Type::Go;
+        std::array<float, 6> values{}; // Go: x y z, Curve: x1 y1 z1 x2 y2 z2, Turn: angle
+        float speed_cmps = 0.f;
+    };
+
+#ifndef _WIN32
+    // Layout of the POSIX shared-memory telemetry ring. The Tello that owns the data port
+    // is the only writer; every slot is a seqlock, so readers never block the writer.
+    struct SharedTelemetry {
+        static constexpr uint32_t MAGIC = 0x4F4C4C54; // "TLLO"
+        static constexpr uint32_t VERSION = 3;
+
+        struct alignas(64) Header {
+            uint32_t magic;
+            uint32_t version;
+            uint32_t slotCount;
+            uint32_t rawCapacity;
+            std::atomic<uint64_t> head;    // Number of samples published so far
+            std::atomic<uint32_t> closed;  // Set once the publisher is gone, nothing is published after it
+            int32_t publisherPid;
+        };
+
+        struct alignas(64) Slot {
+            std::atomic<uint64_t> seq;  // 2 * index + 2 once sample 'index' is complete, odd while it is written
+            TelloState state;
+            uint32_t rawSize;
+            char raw[TelloDefaults::SHM_RAW_CAPACITY];
+        };
+
+        static_assert(std::atomic<uint64_t>::is_always_lock_free, "Shared telemetry requires lock-free 64-bit atomics");
+        static_assert(std::is_trivially_copyable_v<TelloState>);
+
+        static size_t size(uint32_t slotCount) {
+            return sizeof(Header) + static_cast<size_t>(slotCount) * sizeof(Slot);
         }
-    }
 
-    bool connect(std::string_view ipAddress_sv = TelloDefaults::IP) {
-        ipAddress = ipAddress_sv;
-        PRINTF_INFO("[Tello] Connecting to {}", ipAddress);
+        // shm_open() names must start with a single '/' to be portable
+        static std::string object_name(std::string_view name) {
+            return name.starts_with('/') ? std::string(name) : std::format("/{}", name);
+        }
+    };
 
-        bool success = false;
-        for (int i = 0; i < 10; ++i) {
-            if (execute_command("command")) {
-                success = true;
-                break;
-            }
-            if (i < 9) { // Don't log warning or sleep on the last attempt
-                 PRINTF_WARN("[Tello] Tello not found: Timeout. Retrying ({}/10)...", i + 1);
-                 std::this_thread::sleep_for(std::chrono::seconds(1));
+    // Read-only view of a telemetry ring published with Tello::enable_shared_telemetry().
+    // Can be used by any process on the same machine, no Tello instance or socket required.
+    class TelemetrySubscriber {
+    public:
+        struct Sample {
+            uint64_t index = 0;
+            TelloState state;
+            uint32_t rawSize = 0;
+            std::array<char, TelloDefaults::SHM_RAW_CAPACITY> rawData{};
+
+            std::string_view raw() const { return { rawData.data(), rawSize }; }
+        };
+
+        TELLO_INLINE TelemetrySubscriber(std::string_view name);
+
+        ~TelemetrySubscriber() {
+            if (header)
+                ::munmap(const_cast<SharedTelemetry::Header*>(header), mappedSize);
+        }
+
+        TelemetrySubscriber(const TelemetrySubscriber&) = delete;
+        TelemetrySubscriber& operator=(const TelemetrySubscriber&) = delete;
+
+        bool is_open() const { return header != nullptr; }
+
+        uint64_t published() const {
+            return header ? header->head.load(std::memory_order_acquire) : 0;
+        }
+
+        // True once the publishing Tello disabled the ring or was destroyed. The samples can still be
+        // read, but no new ones will follow: open a new subscriber to follow the next ring of that name.
+        bool is_closed() const {
+            return !header || header->closed.load(std::memory_order_acquire) != 0;
+        }
+
+        // True if the name no longer refers to this ring, e.g. because enable_shared_telemetry() created
+        // a new one or the publisher crashed and was restarted. Costs a few syscalls, check it occasionally.
+        TELLO_INLINE bool is_replaced() const;
+
+        // Returns sample 'index', or nothing if it was not published yet or has already been overwritten
+        TELLO_INLINE std::optional<Sample> read(uint64_t index) const;
+
+        std::optional<Sample> latest() const {
+            uint64_t head = published();
+            while (head > 0) {
+                if (auto sample = read(head - 1)) return sample;
+
+                // Only retry if the publisher is still making progress
+                const uint64_t next = published();
+                if (next == head) break;
+                head = next;
             }
+            return std::nullopt;
         }
-        
-        if (!success) {
-            PRINTF_ERROR("[Tello] Failed to connect after 10 attempts. Please check the connection.");
-            connected = false;
-            return false;
+
+        // Returns the next sample this subscriber has not seen yet. A reader that falls more than
+        // one ring behind skips ahead to the oldest sample still available.
+        std::optional<Sample> poll() {
+            const uint64_t head = published();
+            if (head - cursor > slotCount) cursor = head - slotCount;
+
+            while (cursor < head) {
+                if (auto sample = read(cursor++)) return sample;
+            }
+            return std::nullopt;
         }
 
-        connected = true;
-        float battery = get_battery_level();
-        PRINTF_INFO("[Tello] Connected: Battery level {:.0f}%", battery);
+    private:
+        std::string objectName;
+        ino_t inode = 0;
+        const SharedTelemetry::Header* header = nullptr;
+        const SharedTelemetry::Slot* slots = nullptr;
+        uint32_t slotCount = 0;
+        size_t mappedSize = 0;
+        uint64_t cursor = 0;
+    };
+
+private:
+    class TelemetryPublisher {
+    public:
+        TELLO_INLINE TelemetryPublisher(std::string_view name, bool includeRaw);
 
-        if (battery < 5.f) {
-            PRINTF_ERROR("[Tello] ERROR: The battery level is below 5%! Do not fly!");
-            connected = false;
-            return false;
+        ~TelemetryPublisher() {
+            if (header) {
+                header->closed.store(1, std::memory_order_release);
+                ::munmap(header, mappedSize);
+                ::shm_unlink(objectName.c_str());
+            }
         }
-        else if (battery < 10.f) {
-            PRINTF_WARN("[Tello] WARNING: The battery level is below 10%!");
+
+        TelemetryPublisher(const TelemetryPublisher&) = delete;
+        TelemetryPublisher& operator=(const TelemetryPublisher&) = delete;
+
+        bool is_open() const { return header != nullptr; }
+
+        void publish(const TelloState& state, std::string_view raw) {
+            const uint64_t index = header->head.load(std::memory_order_relaxed);
+            auto& slot = slots[index % TelloDefaults::SHM_SLOT_COUNT];
+
+            slot.seq.store(2 * index + 1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+
+            std::memcpy(&slot.state, &state, sizeof(state));
+            const size_t rawSize = includeRaw ? std::min<size_t>(raw.size(), TelloDefaults::SHM_RAW_CAPACITY) : 0;
+            std::memcpy(slot.raw, raw.data(), rawSize);
+            slot.rawSize = static_cast<uint32_t>(rawSize);
+
+            slot.seq.store(2 * index + 2, std::memory_order_release);
+            header->head.store(index + 1, std::memory_order_release);
         }
-        return true;
+
+    private:
+        // The process that publishes the existing ring 'objectName', if it is still running
+        TELLO_INLINE static std::optional<pid_t> live_publisher(const std::string& objectName);
+
+        std::string objectName;
+        bool includeRaw = false;
+        SharedTelemetry::Header* header = nullptr;
+        SharedTelemetry::Slot* slots = nullptr;
+        size_t mappedSize = 0;
+    };
+#endif
+
+public:
+    Tello(
+        uint16_t cmdPort = TelloDefaults::COMMAND_PORT,
+        uint16_t dataPort = TelloDefaults::DATA_PORT,
+        uint16_t locPort = TelloDefaults::LOCAL_PORT) :
+        Tello(std::make_unique<UdpTransport>(cmdPort, dataPort, locPort))
+    {
     }
 
+    TELLO_INLINE explicit Tello(std::unique_ptr<Transport> transport);
+    TELLO_INLINE ~Tello();
+
+    TELLO_INLINE bool connect(std::string_view ipAddress_sv = TelloDefaults::IP);
+
     // =============================================
     // ===                                       ===
     // ===   Implementation of the Tello SDK 2.0   ===
@@ -669,8 +1181,35 @@ public:
         return execute_action("curve {} {} {} {} {} {} {}", start_x, start_y, start_z, end_x, end_y, end_z, speed_cmps);
     }
 
+    // Compiles a list of waypoints into the smallest sequence of SDK commands that flies it:
+    // collinear segments are merged and only the segments longer than the SDK limit are split.
+    // A 'curve' is only flown where the path is an arc: through a waypoint marked as 'arc', or along
+    // at least four consecutive points that lie on one circle, merged into as few curves as the SDK's
+    // range allows. Everything else is flown with 'go'.
+    // Returns nothing if the path ends closer to the last reached point than the SDK can fly.
+    TELLO_INLINE static std::optional<std::vector<PathStep>> compile_path(std::span<const Waypoint> waypoints, const PathOptions& options);
+
+    static std::optional<std::vector<PathStep>> compile_path(std::span<const Waypoint> waypoints) {
+        return compile_path(waypoints, PathOptions{});
+    }
+
+    TELLO_INLINE bool fly_path(std::span<const PathStep> steps);
+
+    bool fly_waypoints(std::span<const Waypoint> waypoints, const PathOptions& options) {
+        auto steps = compile_path(waypoints, options);
+        return steps.has_value() && fly_path(*steps);
+    }
+
+    bool fly_waypoints(std::span<const Waypoint> waypoints) {
+        return fly_waypoints(waypoints, PathOptions{});
+    }
+
     // === Set Commands ===
-    bool set_speed(float speed) { return execute_command("speed {}", speed); }
+    bool set_speed(float speed) {
+        if (!execute_command("speed {}", speed)) return false;
+        actionSpeed = speed;
+        return true;
+    }
     bool move(float left_right, float forward_back, float up_down, float yaw) {
         return execute_command("rc {} {} {} {}", left_right, forward_back, up_down, yaw);
     }
@@ -715,12 +1254,77 @@ public:
         commandTimeout = timeout_ms;
     }
 
+    // Applies to every thread the library runs, i.e. the telemetry listener of the UDP transport.
+    // Commands are sent from the caller's thread, see configure_this_thread().
+    bool configure_threads(const ThreadConfig& config) {
+        return transport->configure_threads(config);
+    }
+
+    // Applies the configuration to the calling thread, e.g. the one that sends the commands
+    static bool configure_this_thread(const ThreadConfig& config) {
+        bool success = apply_thread_config(current_thread(), config);
+        if (config.prefault) prefault_stack();
+        return success;
+    }
+
+    std::vector<ThreadStats> thread_stats() const {
+        return transport->thread_stats();
+    }
+
+    // Derives the deadline of every action from its arguments (distance, angle and speed) instead
+    // of using the fixed action timeout, which then only serves as an upper bound. Actions that stop
+    // making progress according to the telemetry are aborted after TelloDefaults::ACTION_STALL_MS.
+    void set_adaptive_action_timeout(bool enable) {
+        adaptiveActionTimeout = enable;
+    }
+
+    // Progress of the action currently in flight, or of the last one if none is
+    TELLO_INLINE ActionProgress action_progress();
+
     TelloState state() {
         std::lock_guard lock(stateMTX);
         return _state;
     }
 
+#ifndef _WIN32
+    // Publishes every parsed telemetry packet into the shared-memory ring 'name', where any local
+    // process can read it with a TelemetrySubscriber. The raw packet is only copied if requested.
+    bool enable_shared_telemetry(std::string_view name, bool includeRaw = false) {
+        disable_shared_telemetry();
+
+        auto publisher = std::make_unique<TelemetryPublisher>(name, includeRaw);
+        if (!publisher->is_open())
+            return false;
+
+        std::lock_guard lock(stateMTX);
+        telemetryPublisher = std::move(publisher);
+        return true;
+    }
+
+    void disable_shared_telemetry() {
+        std::lock_guard lock(stateMTX);
+        telemetryPublisher.reset();
+    }
+#endif
+
 private:
+    static std::thread::native_handle_type current_thread() {
+#ifdef _WIN32
+        return ::GetCurrentThread();
+#else
+        return ::pthread_self();
+#endif
+    }
+
+    // Returns false if any part of the configuration could not be applied, e.g. for lack of privileges
+    TELLO_INLINE static bool apply_thread_config(std::thread::native_handle_type thread, const ThreadConfig& config);
+
+    static void prefault_stack() {
+        volatile char stack[TelloDefaults::PREFAULT_STACK_BYTES];
+        for (size_t i = 0; i < sizeof(stack); i += 4096)
+            stack[i] = 0;
+    }
+
     template<typename T>
     T parse_value(std::string_view sv) {
         T value{};
@@ -744,7 +1348,58 @@ private:
     
     template<typename... TArgs>
     bool execute_action(std::string_view fmt, TArgs&&... args) {
-        return execute_command_raw(std::vformat(fmt, std::make_format_args(args...)), actionTimeout);
+        return execute_action_raw(std::vformat(fmt, std::make_format_args(args...)));
+    }
+
+    enum class ActionKind { Timed, Linear, Vertical, Rotation, Takeoff, Land };
+
+    // Expected motion of an action, derived from its command arguments
+    struct ActionEstimate {
+        ActionKind kind = ActionKind::Timed;
+        float amount = 0.f;  // cm, or degrees for rotations
+        int expected_ms = 0; // 0 = unknown
+    };
+
+    TELLO_INLINE ActionEstimate estimate_action(std::string_view command);
+
+    int action_timeout(const ActionEstimate& estimate) const {
+        if (!adaptiveActionTimeout || estimate.expected_ms <= 0)
+            return actionTimeout;
+
+        int timeout = static_cast<int>(estimate.expected_ms * TelloDefaults::ACTION_TIMEOUT_FACTOR) + TelloDefaults::ACTION_TIMEOUT_MARGIN_MS;
+        return actionTimeout > 0 ? std::min(actionTimeout, timeout) : timeout;
+    }
+
+    TELLO_INLINE bool execute_action_raw(std::string_view str);
+
+    // Called for every telemetry packet while an action is in flight, stateMTX must be held
+    TELLO_INLINE void update_action_progress();
+
+    // stateMTX must be held
+    bool action_stalled(std::chrono::steady_clock::time_point now) const {
+        using namespace std::chrono;
+        const auto stallTime = milliseconds(TelloDefaults::ACTION_STALL_MS);
+        if (!action.active || action.estimate.kind == ActionKind::Timed || action.estimate.amount <= 0.f)
+            return false;
+        if (action.lastTelemetry < action.start || now - action.lastTelemetry > stallTime)
+            return false; // Without telemetry there is no way to tell
+        return action.percent < 95.f && now - action.lastProgress > stallTime;
+    }
+
+    // Waits for the response to an action in short slices, so a stalled action can be abandoned early
+    TELLO_INLINE std::optional<std::string> recv_action_response(std::string_view str, int timeout_ms, bool silent);
+
+    // requestMTX must be held. Stops the drone; the late response to the action and the response
+    // to 'stop' are discarded, so they are not taken for the responses to the following commands.
+    TELLO_INLINE void abandon_action(bool silent);
+
+    // requestMTX must be held
+    void drain_stale_responses(int timeout_ms) {
+        while (staleResponses > 0) {
+            auto response = transport->recv(timeout_ms);
+            if (!response.has_value()) break;
+            --staleResponses;
+        }
     }
 
     std::string get_str(std::string_view str, bool silent = false) {
@@ -752,8 +1407,8 @@ private:
         return response.value_or("");
     }
 
-    bool execute_command_raw(std::string_view str, int timeout_ms, bool silent = false) {
-        auto response = send_request(str, timeout_ms, silent);
+    bool execute_command_raw(std::string_view str, int timeout_ms, bool silent = false, bool isAction = false) {
+        auto response = send_request(str, timeout_ms, silent, isAction);
         if (!response.has_value())
             return false;
 
@@ -764,78 +1419,896 @@ private:
         return true;
     }
 
-    std::optional<std::string> send_request(std::string_view str, int timeout_ms, bool silent) {
-        if (!connected) {
-            if (!silent) PRINTF_ERROR("[Tello] Tello not connected");
-            return std::nullopt;
+    TELLO_INLINE std::optional<std::string> send_request(std::string_view str, int timeout_ms, bool silent, bool isAction = false);
+
+    TELLO_INLINE void OnDataStream(std::string_view data);
+
+private:
+    std::unique_ptr<Transport> transport;
+
+    bool connected = false;
+
+    std::string ipAddress;
+    int commandTimeout = TelloDefaults::COMMAND_TIMEOUT_MS;
+    int actionTimeout = TelloDefaults::ACTION_TIMEOUT_MS;
+    bool adaptiveActionTimeout = false;
+    float actionSpeed = TelloDefaults::ACTION_SPEED_CMPS;
+
+    std::mutex requestMTX;
+    int staleResponses = 0; // Responses still expected from abandoned actions, guarded by requestMTX
+    std::mutex stateMTX;
+    TelloState _state;
+
+    struct ActionTracker {
+        std::string command;
+        ActionEstimate estimate;
+        bool active = false;
+        bool stalled = false;
+        std::chrono::steady_clock::time_point start, end, lastTelemetry, lastProgress;
+        TelloState startState;
+        int32_t lastYaw = 0;
+        float travelled = 0.f;
+        float percent = 0.f;
+    } action; // Guarded by stateMTX
+
+#ifndef _WIN32
+    std::unique_ptr<TelemetryPublisher> telemetryPublisher;
+#endif
+};
+
+// =========================================
+// ===                                   ===
+// ===   Out-of-line implementation      ===
+// ===                                   ===
+// =========================================
+
+#if !defined(TELLO_SEPARATE_COMPILATION) || defined(TELLO_IMPLEMENTATION)
+
+TELLO_INLINE void LogLine(LogColor color, std::string_view message) {
+    const char* color_code;
+    switch (color) {
+        case LogColor::Red:    color_code = "1;91"; break;
+        case LogColor::Green:  color_code = "0;92"; break;
+        case LogColor::Blue:   color_code = "1;94"; break;
+        case LogColor::Yellow: color_code = "0;93"; break;
+        default:               color_code = "0;97"; break;
+    }
+    std::cout << std::format("\033[{}m{}\033[m\n", color_code, message);
+}
+
+TELLO_INLINE Tello::ActionEstimate Tello::estimate_action(std::string_view command) {
+    std::string_view verb;
+    std::array<float, 8> args{};
+    size_t count = 0;
+    for (const auto token_range : command | std::views::split(' ')) {
+        std::string_view token(token_range.begin(), token_range.end());
+        if (token.empty()) continue;
+        if (verb.empty()) { verb = token; continue; }
+        if (token.starts_with('m')) continue; // Mission pad ID
+        if (count < args.size()) args[count++] = parse_value<float>(token);
+    }
+
+    auto duration_ms = [](float amount, float rate) {
+        return rate > 0.f ? static_cast<int>(1000.f * std::abs(amount) / rate) : 0;
+    };
+
+    ActionEstimate estimate;
+    if (verb == "forward" || verb == "back" || verb == "left" || verb == "right") {
+        estimate = { ActionKind::Linear, args[0], duration_ms(args[0], actionSpeed) };
+    }
+    else if (verb == "up" || verb == "down") {
+        estimate = { ActionKind::Vertical, args[0], duration_ms(args[0], actionSpeed) };
+    }
+    else if (verb == "cw" || verb == "ccw") {
+        estimate = { ActionKind::Rotation, args[0], duration_ms(args[0], TelloDefaults::ACTION_YAW_RATE_DPS) };
+    }
+    else if (verb == "go") {
+        float distance = std::hypot(args[0], args[1], args[2]);
+        estimate = { ActionKind::Linear, distance, duration_ms(distance, args[3]) };
+    }
+    else if (verb == "curve") {
+        // Approximate the arc by the two chords through the intermediate point
+        float distance = std::hypot(args[0], args[1], args[2]) + std::hypot(args[3] - args[0], args[4] - args[1], args[5] - args[2]);
+        estimate = { ActionKind::Linear, distance, duration_ms(distance, args[6]) };
+    }
+    else if (verb == "jump") {
+        float distance = std::hypot(args[0], args[1], args[2]);
+        estimate = { ActionKind::Linear, distance, duration_ms(distance, args[3]) + duration_ms(args[4], TelloDefaults::ACTION_YAW_RATE_DPS) };
+    }
+    else if (verb == "takeoff") {
+        estimate = { ActionKind::Takeoff, TelloDefaults::ACTION_TAKEOFF_HEIGHT_CM, TelloDefaults::ACTION_TAKEOFF_MS };
+    }
+    else if (verb == "land") {
+        estimate = { ActionKind::Land, 0.f, TelloDefaults::ACTION_LAND_MS };
+    }
+    else if (verb == "flip") {
+        estimate = { ActionKind::Timed, 0.f, TelloDefaults::ACTION_FLIP_MS };
+    }
+    return estimate;
+}
+
+TELLO_INLINE void Tello::OnDataStream(std::string_view data) {
+    std::unique_lock lock(stateMTX);
+    for (const auto token_range : data | std::views::split(';')) {
+        std::string_view token(token_range.begin(), token_range.end());
+        if (token.empty()) continue;
+
+        auto pos = token.find(':');
+        if (pos == std::string_view::npos) continue;
+
+        auto key = token.substr(0, pos);
+        auto value = token.substr(pos + 1);
+
+        if (key == "mid")      _state.mp_id = parse_value<int32_t>(value);
+        else if (key == "x")   _state.mp_x = parse_value<int32_t>(value);
+        else if (key == "y")   _state.mp_y = parse_value<int32_t>(value);
+        else if (key == "z")   _state.mp_z = parse_value<int32_t>(value);
+        else if (key == "mpry") {
+            std::array<int32_t*, 3> fields{ &_state.mp_pitch, &_state.mp_roll, &_state.mp_yaw };
+            size_t i = 0;
+            for (const auto part : value | std::views::split(',')) {
+                if (i == fields.size()) break;
+                *fields[i++] = parse_value<int32_t>(std::string_view(part.begin(), part.end()));
+            }
         }
+        else if (key == "pitch") _state.pitch = parse_value<int32_t>(value);
+        else if (key == "roll")  _state.roll = parse_value<int32_t>(value);
+        else if (key == "yaw")   _state.yaw = parse_value<int32_t>(value);
+        else if (key == "vgx")  _state.vgx = parse_value<int32_t>(value);
+        else if (key == "vgy")  _state.vgy = parse_value<int32_t>(value);
+        else if (key == "vgz")  _state.vgz = parse_value<int32_t>(value);
+        else if (key == "templ") _state.templ = parse_value<int32_t>(value);
+        else if (key == "temph") _state.temph = parse_value<int32_t>(value);
+        else if (key == "tof")   _state.height = parse_value<uint32_t>(value);
+        else if (key == "h")     _state.h = parse_value<uint32_t>(value);
+        else if (key == "bat")   _state.battery = parse_value<uint32_t>(value);
+        else if (key == "baro")  _state.sea_height = parse_value<float>(value);
+        else if (key == "time")  _state.time = parse_value<int32_t>(value);
+        else if (key == "agx")   _state.agx = parse_value<float>(value);
+        else if (key == "agy")   _state.agy = parse_value<float>(value);
+        else if (key == "agz")   _state.agz = parse_value<float>(value);
+    }
 
-        if (!silent) PRINTF_DEBUG("[Tello] DEBUG: Sending command '{}'", str);
+    if (action.active)
+        update_action_progress();
 
-        std::unique_lock lock(requestMTX);
-        if (!commandServer.send(ipAddress, commandPort, str)) {
-            if (!silent) PRINTF_ERROR("[Tello] Failed to send command '{}': Socket error", str);
-            return std::nullopt;
+#ifndef _WIN32
+    if (telemetryPublisher)
+        telemetryPublisher->publish(_state, data);
+#endif
+
+    const TelloState snapshot = _state;
+    lock.unlock(); // Pad event callbacks may call back into the Tello
+    missionPadAPI.update(snapshot);
+}
+
+TELLO_INLINE Tello::ThreadStats Tello::LatencyRecorder::stats(std::string name) const {
+    ThreadStats stats;
+    stats.name = std::move(name);
+    stats.samples = samples.load(std::memory_order_relaxed);
+    if (stats.samples == 0) return stats;
+
+    stats.mean_us = static_cast<double>(totalUs.load(std::memory_order_relaxed)) / static_cast<double>(stats.samples);
+    stats.max_us = maxUs.load(std::memory_order_relaxed);
+
+    auto percentile = [&](double p) {
+        const auto rank = static_cast<uint64_t>(p * static_cast<double>(stats.samples));
+        uint64_t seen = 0;
+        for (size_t bucket = 0; bucket < buckets.size(); ++bucket) {
+            seen += buckets[bucket].load(std::memory_order_relaxed);
+            if (seen > rank) return std::min((uint64_t(1) << bucket) - 1, stats.max_us);
+        }
+        return stats.max_us;
+    };
+    stats.p50_us = percentile(0.50);
+    stats.p99_us = percentile(0.99);
+    return stats;
+}
+
+TELLO_INLINE Tello::SyncSocket::SyncSocket(uint16_t sourcePort) {
+    if (socket.open() < 0) {
+        PRINTF_ERROR("SyncSocket::SyncSocket: socket.open() failed.");
+        return;
+    }
+    if (socket.bind(sourcePort) < 0) {
+        PRINTF_ERROR("SyncSocket::SyncSocket: socket.bind() failed. Port {} may be in use.", sourcePort);
+        return;
+    }
+}
+
+TELLO_INLINE Tello::AsyncSocket::AsyncSocket(uint16_t port, std::function<void(std::string_view)> cb, const ThreadConfig& config)
+: callback(std::move(cb)), threadName(config.name) {
+    if (socket.open() < 0) {
+        PRINTF_ERROR("AsyncSocket::AsyncSocket: socket.open() failed.");
+        return;
+    }
+    if (socket.bind(port) < 0) {
+        PRINTF_ERROR("AsyncSocket::AsyncSocket: socket.bind() failed. Port {} may be in use.", port);
+        return;
+    }
+    listener = std::jthread([this, config](std::stop_token st) {
+        if (!apply_thread_config(current_thread(), config))
+            PRINTF_WARN("AsyncSocket::listen: The thread configuration could not be fully applied.");
+        if (config.prefault)
+            prefault_stack();
+        listen(st);
+    });
+}
+
+TELLO_INLINE void Tello::AsyncSocket::listen(std::stop_token st) {
+    // Allocated once, so receiving a packet never touches the heap
+    std::vector<uint8_t> buffer;
+    buffer.reserve(2048);
+
+    while (!st.stop_requested()) {
+        UDPsocket::IPv4 ipaddr;
+        int error = socket.recv(buffer, ipaddr);
+
+        if (st.stop_requested()) break;
+
+        if (error < 0) {
+            PRINTF_ERROR("AsyncSocket::listen: socket.recv() failed: Error code {}", error);
+            continue;
+        }
+
+        record_latency();
+        if (prefaultPending.exchange(false))
+            prefault_stack();
+
+        if (callback)
+            callback({reinterpret_cast<const char*>(buffer.data()), buffer.size()});
+    }
+}
+
+TELLO_INLINE void Tello::AsyncSocket::record_latency() {
+#ifdef __linux__
+    // The kernel's receive timestamp of the packet that was just read
+    struct timeval arrival{};
+    if (::ioctl(socket.get_raw_socket(), SIOCGSTAMP, &arrival) == 0) {
+        const std::chrono::system_clock::time_point arrived{ std::chrono::seconds(arrival.tv_sec) + std::chrono::microseconds(arrival.tv_usec) };
+        latency.record(std::chrono::system_clock::now() - arrived);
+    }
+#endif
+}
+
+TELLO_INLINE void Tello::MissionPadAPI::update(const TelloState& state) {
+    const auto now = std::chrono::steady_clock::now();
+    std::array<std::pair<PadEvent, PadSighting>, TelloDefaults::MAX_PAD_ID + 1> events;
+    size_t eventCount = 0;
+    std::function<void(PadEvent, const PadSighting&)> callback;
+    {
+        std::lock_guard lock(padMTX);
+        if (state.mp_id >= 1 && state.mp_id <= TelloDefaults::MAX_PAD_ID) {
+            auto& pad = pads[state.mp_id];
+            const bool acquired = !pad.visible;
+            pad = { state.mp_id, state.mp_x, state.mp_y, state.mp_z, state.mp_pitch, state.mp_roll, state.mp_yaw, true, now };
+            if (acquired) events[eventCount++] = { PadEvent::Acquired, pad };
+        }
+
+        for (auto& pad : pads) {
+            if (pad.visible && expired(pad, now)) {
+                pad.visible = false;
+                events[eventCount++] = { PadEvent::Lost, pad };
+            }
+        }
+
+        if (eventCount > 0) callback = padCallback;
+    }
+
+    for (size_t i = 0; i < eventCount && callback; ++i)
+        callback(events[i].first, events[i].second);
+}
+
+TELLO_INLINE bool Tello::connect(std::string_view ipAddress_sv) {
+    ipAddress = ipAddress_sv;
+    PRINTF_INFO("[Tello] Connecting to {}", ipAddress);
+
+    connected = true; // send_request() refuses to send anything otherwise
+    bool success = false;
+    for (int i = 0; i < 10; ++i) {
+        if (execute_command("command")) {
+            success = true;
+            break;
+        }
+        if (i < 9) { // Don't log warning or sleep on the last attempt
+             PRINTF_WARN("[Tello] Tello not found: Timeout. Retrying ({}/10)...", i + 1);
+             std::this_thread::sleep_for(std::chrono::seconds(1));
+        }
+    }
+    
+    if (!success) {
+        PRINTF_ERROR("[Tello] Failed to connect after 10 attempts. Please check the connection.");
+        connected = false;
+        return false;
+    }
+
+    connected = true;
+    float battery = get_battery_level();
+    PRINTF_INFO("[Tello] Connected: Battery level {:.0f}%", battery);
+
+    if (battery < 5.f) {
+        PRINTF_ERROR("[Tello] ERROR: The battery level is below 5%! Do not fly!");
+        connected = false;
+        return false;
+    }
+    else if (battery < 10.f) {
+        PRINTF_WARN("[Tello] WARNING: The battery level is below 10%!");
+    }
+    return true;
+}
+
+TELLO_INLINE std::optional<std::vector<Tello::PathStep>> Tello::compile_path(std::span<const Waypoint> waypoints, const PathOptions& options) {
+    using Vec3 = std::array<float, 3>;
+    auto add = [](const Vec3& a, const Vec3& b) { return Vec3{ a[0] + b[0], a[1] + b[1], a[2] + b[2] }; };
+    auto sub = [](const Vec3& a, const Vec3& b) { return Vec3{ a[0] - b[0], a[1] - b[1], a[2] - b[2] }; };
+    auto scale = [](const Vec3& v, float f) { return Vec3{ v[0] * f, v[1] * f, v[2] * f }; };
+    auto dot = [](const Vec3& a, const Vec3& b) { return a[0] * b[0] + a[1] * b[1] + a[2] * b[2]; };
+    auto norm = [](const Vec3& v) { return std::hypot(v[0], v[1], v[2]); };
+    auto cross = [](const Vec3& a, const Vec3& b) {
+        return Vec3{ a[1] * b[2] - a[2] * b[1], a[2] * b[0] - a[0] * b[2], a[0] * b[1] - a[1] * b[0] };
+    };
+    auto max_abs = [](const Vec3& v) { return std::max({ std::abs(v[0]), std::abs(v[1]), std::abs(v[2]) }); };
+    auto whole = [](float v) { return std::round(v) + 0.f; }; // + 0.f turns -0 into 0
+    auto point = [](const Waypoint& w) { return Vec3{ w.x, w.y, w.z }; };
+
+    const float goSpeed = std::clamp(options.speed_cmps, TelloDefaults::SPEED_MIN_CMPS, TelloDefaults::GO_SPEED_MAX_CMPS);
+    const float curveSpeed = std::clamp(options.speed_cmps, TelloDefaults::SPEED_MIN_CMPS, TelloDefaults::CURVE_SPEED_MAX_CMPS);
+
+    // Drop every waypoint that lies on the straight line between its neighbours
+    std::vector<Waypoint> nodes;
+    Vec3 previous{};
+    for (size_t i = 0; i < waypoints.size(); ++i) {
+        const Vec3 current = point(waypoints[i]);
+        const bool keep = waypoints[i].heading || waypoints[i].arc || (i > 0 && waypoints[i - 1].arc);
+        if (!keep && i + 1 < waypoints.size()) {
+            const Vec3 next = point(waypoints[i + 1]);
+            const Vec3 a = sub(current, previous), b = sub(next, current);
+            const float length = norm(sub(next, previous));
+            if (length > 0.f && dot(a, b) >= 0.f && norm(cross(a, sub(next, previous))) / length <= options.tolerance_cm)
+                continue;
+        }
+        nodes.push_back(waypoints[i]);
+        previous = current;
+    }
+
+    // Circle through three points, its normal points along (b - a) x (c - a)
+    struct Circle { Vec3 center, normal; float radius = 0.f; };
+    auto circle_through = [&](const Vec3& a, const Vec3& b, const Vec3& c) -> std::optional<Circle> {
+        const Vec3 ab = sub(b, a), ac = sub(c, a);
+        const Vec3 n = cross(ab, ac);
+        const float n2 = dot(n, n);
+        if (n2 <= 1e-6f) return std::nullopt;
+        const Vec3 offset = scale(add(scale(cross(n, ab), dot(ac, ac)), scale(cross(ac, n), dot(ab, ab))), 0.5f / n2);
+        return Circle{ add(a, offset), scale(n, 1.f / std::sqrt(n2)), norm(offset) };
+    };
+    // Angle from 'a' to 'b' around the circle, in the direction of its normal, in [0, 2pi)
+    auto angle_on = [&](const Circle& circle, const Vec3& a, const Vec3& b) {
+        const Vec3 ra = sub(a, circle.center), rb = sub(b, circle.center);
+        const float angle = std::atan2(dot(cross(ra, rb), circle.normal), dot(ra, rb));
+        return angle < 0.f ? angle + 2.f * 3.14159265f : angle;
+    };
+    // Whether 'p' lies on the circle and follows 'from' in the direction of travel
+    auto continues_arc = [&](const Circle& circle, const Vec3& from, const Vec3& p) {
+        const Vec3 r = sub(p, circle.center);
+        return std::abs(dot(r, circle.normal)) <= options.tolerance_cm &&
+            std::abs(norm(r) - circle.radius) <= options.tolerance_cm &&
+            dot(cross(sub(from, circle.center), r), circle.normal) > 0.f;
+    };
+
+    std::vector<PathStep> steps;
+    Vec3 position{};
+    float heading = 0.f;
+
+    // World frame -> body frame, rounded to whole cm as the SDK expects
+    auto to_body = [&](const Vec3& d) {
+        const float rad = heading * 3.14159265f / 180.f;
+        const float c = std::cos(rad), s = std::sin(rad);
+        return Vec3{ whole(d[0] * c - d[1] * s), whole(d[0] * s + d[1] * c), whole(d[2]) };
+    };
+    auto to_world = [&](const Vec3& b) {
+        const float rad = heading * 3.14159265f / 180.f;
+        const float c = std::cos(rad), s = std::sin(rad);
+        return Vec3{ b[0] * c + b[1] * s, -b[0] * s + b[1] * c, b[2] };
+    };
+    auto advance = [&](const Vec3& body) {
+        const Vec3 d = to_world(body);
+        position = { position[0] + d[0], position[1] + d[1], position[2] + d[2] };
+    };
+    // Adds a 'curve' from the current position through 'mid' to 'end' if the SDK can fly it
+    auto try_curve = [&](const Vec3& midWorld, const Vec3& endWorld) {
+        const Vec3 mid = to_body(sub(midWorld, position));
+        const Vec3 end = to_body(sub(endWorld, position));
+        for (const auto& p : { mid, end }) {
+            if (max_abs(p) > TelloDefaults::GO_MAX_CM || max_abs(p) < TelloDefaults::GO_MIN_CM) return false;
+        }
+        const float area = norm(cross(mid, end));
+        if (area <= 0.f) return false;
+        const float radius = norm(mid) * norm(end) * norm(sub(end, mid)) / (2.f * area);
+        if (radius < TelloDefaults::CURVE_RADIUS_MIN_CM || radius > TelloDefaults::CURVE_RADIUS_MAX_CM) return false;
+
+        steps.push_back({ PathStep::Type::Curve, { mid[0], mid[1], mid[2], end[0], end[1], end[2] }, curveSpeed });
+        advance(end);
+        return true;
+    };
+
+    for (size_t i = 0; i < nodes.size(); ++i) {
+        if (options.allow_arcs && !nodes[i].heading && i + 1 < nodes.size()) {
+            if (nodes[i].arc) {
+                if (try_curve(point(nodes[i]), point(nodes[i + 1])))
+                    ++i;
+            }
+            else if (auto circle = circle_through(position, point(nodes[i]), point(nodes[i + 1]))) {
+                // Extend the arc for as long as the following waypoints stay on the circle
+                size_t last = i + 1;
+                while (last + 1 < nodes.size() && !nodes[last].heading && !nodes[last].arc &&
+                       continues_arc(*circle, point(nodes[last]), point(nodes[last + 1])))
+                    ++last;
+
+                // Together with the current position, at least four points are needed to call it an arc
+                if (last >= i + 2) {
+                    // The run starts at the current position, followed by nodes[i..last]
+                    std::vector<Vec3> run{ position };
+                    std::vector<float> sweep{ 0.f }; // Angle travelled along the circle, in radians
+                    for (size_t j = i; j <= last; ++j) {
+                        run.push_back(point(nodes[j]));
+                        sweep.push_back(sweep.back() + angle_on(*circle, run[run.size() - 2], run.back()));
+                    }
+
+                    // Every curve ends at the farthest point the SDK can reach, through the point closest
+                    // to the middle of that arc. Only the final point is flown through the arc's middle.
+                    size_t from = 0;
+                    while (from + 1 < run.size()) {
+                        size_t to = run.size() - 1;
+                        for (; to >= from + 2; --to) {
+                            if (sweep[to] - sweep[from] >= 2.f * 3.14159265f - 0.01f) continue;
+                            const float middle = (sweep[from] + sweep[to]) / 2.f;
+                            size_t mid = from + 1;
+                            for (size_t j = from + 2; j < to; ++j) {
+                                if (std::abs(sweep[j] - middle) < std::abs(sweep[mid] - middle)) mid = j;
+                            }
+                            if (try_curve(run[mid], run[to])) break;
+                        }
+                        if (to < from + 2) {
+                            to = from + 1;
+                            const Vec3 chordMid = sub(scale(add(run[from], run[to]), 0.5f), circle->center);
+                            if (norm(chordMid) <= 1e-3f || !try_curve(add(circle->center, scale(chordMid, circle->radius / norm(chordMid))), run[to]))
+                                break;
+                        }
+                        from = to;
+                    }
+                    if (from > 0) i += from - 1; // The rest of the run, if any, is flown straight
+                }
+            }
+        }
+
+        const Vec3 current = point(nodes[i]);
+        const Vec3 delta = to_body(sub(current, position));
+        const int pieces = static_cast<int>(std::ceil(max_abs(delta) / TelloDefaults::GO_MAX_CM));
+        for (int piece = 0; piece < pieces; ++piece) {
+            const Vec3 part = to_body(sub(current, position));
+            const float remaining = static_cast<float>(pieces - piece);
+            const Vec3 step{ whole(part[0] / remaining), whole(part[1] / remaining), whole(part[2] / remaining) };
+            if (max_abs(step) < TelloDefaults::GO_MIN_CM)
+                continue; // Too short for the SDK, the remainder is carried over to the next segment
+            steps.push_back({ PathStep::Type::Go, { step[0], step[1], step[2] }, goSpeed });
+            advance(step);
+        }
+
+        if (nodes[i].heading) {
+            const float turn = whole(std::remainder(*nodes[i].heading - heading, 360.f));
+            if (turn > 0.f) steps.push_back({ PathStep::Type::TurnRight, { turn } });
+            else if (turn < 0.f) steps.push_back({ PathStep::Type::TurnLeft, { -turn } });
+            heading += turn;
         }
+    }
 
-        auto response = commandServer.recv(timeout_ms);
-        if (!response.has_value()) {
-            if (!silent) PRINTF_ERROR("[Tello] Failed to send command '{}': Timeout waiting for response", str);
+    if (!nodes.empty()) {
+        const Vec3 missing = to_body(sub(point(nodes.back()), position));
+        if (max_abs(missing) > options.tolerance_cm) {
+            PRINTF_ERROR("[Tello] compile_path: The last waypoint is {} cm away, below the minimum of {} cm the SDK can fly",
+                max_abs(missing), TelloDefaults::GO_MIN_CM);
             return std::nullopt;
         }
+    }
+    return steps;
+}
+
+TELLO_INLINE bool Tello::fly_path(std::span<const PathStep> steps) {
+    for (const auto& step : steps) {
+        const auto& v = step.values;
+        bool success = false;
+        switch (step.type) {
+            case PathStep::Type::Go:        success = move_by(v[0], v[1], v[2], step.speed_cmps); break;
+            case PathStep::Type::Curve:     success = fly_arc(v[0], v[1], v[2], v[3], v[4], v[5], step.speed_cmps); break;
+            case PathStep::Type::TurnRight: success = turn_right(v[0]); break;
+            case PathStep::Type::TurnLeft:  success = turn_left(v[0]); break;
+        }
+        if (!success) return false;
+    }
+    return true;
+}
+
+TELLO_INLINE Tello::ActionProgress Tello::action_progress() {
+    std::lock_guard lock(stateMTX);
+    const auto now = std::chrono::steady_clock::now();
+    ActionProgress progress;
+    progress.command = action.command;
+    progress.active = action.active;
+    progress.stalled = action.stalled || action_stalled(now);
+    progress.percent = action.percent;
+    progress.elapsed_ms = static_cast<int>(std::chrono::duration_cast<std::chrono::milliseconds>((action.active ? now : action.end) - action.start).count());
+    progress.expected_ms = action.estimate.expected_ms;
+    if (action.active && action.estimate.kind == ActionKind::Timed && action.estimate.expected_ms > 0)
+        progress.percent = std::min(99.f, 100.f * progress.elapsed_ms / action.estimate.expected_ms);
+    return progress;
+}
 
-        return response;
+TELLO_INLINE bool Tello::apply_thread_config(std::thread::native_handle_type thread, const ThreadConfig& config) {
+    bool success = true;
+#if defined(__linux__)
+    if (!config.name.empty()) {
+        const std::string name = config.name.substr(0, 15);
+        success &= ::pthread_setname_np(thread, name.c_str()) == 0;
+    }
+    if (config.cpu >= 0) {
+        cpu_set_t cpus;
+        CPU_ZERO(&cpus);
+        CPU_SET(config.cpu, &cpus);
+        success &= ::pthread_setaffinity_np(thread, sizeof(cpus), &cpus) == 0;
+    }
+    if (config.realtime_priority > 0) {
+        sched_param param{};
+        param.sched_priority = config.realtime_priority;
+        success &= ::pthread_setschedparam(thread, SCHED_FIFO, &param) == 0;
+    }
+#elif defined(_WIN32)
+    if (!config.name.empty()) {
+        const std::wstring name(config.name.begin(), config.name.end());
+        success &= SUCCEEDED(::SetThreadDescription(thread, name.c_str()));
     }
+    if (config.cpu >= 0)
+        success &= ::SetThreadAffinityMask(thread, DWORD_PTR(1) << config.cpu) != 0;
+    if (config.realtime_priority > 0)
+        success &= ::SetThreadPriority(thread, THREAD_PRIORITY_TIME_CRITICAL) != 0;
+#else
+    success = config.name.empty() && config.cpu < 0 && config.realtime_priority <= 0;
+#endif
+    return success;
+}
 
-    void OnDataStream(std::string_view data) {
+TELLO_INLINE bool Tello::execute_action_raw(std::string_view str) {
+    const auto estimate = estimate_action(str);
+    {
         std::lock_guard lock(stateMTX);
-        for (const auto token_range : data | std::views::split(';')) {
-            std::string_view token(token_range.begin(), token_range.end());
-            if (token.empty()) continue;
-
-            auto pos = token.find(':');
-            if (pos == std::string_view::npos) continue;
-
-            auto key = token.substr(0, pos);
-            auto value = token.substr(pos + 1);
-
-            if (key == "mid")      _state.mp_id = parse_value<int32_t>(value);
-            else if (key == "x")   _state.mp_x = parse_value<int32_t>(value);
-            else if (key == "y")   _state.mp_y = parse_value<int32_t>(value);
-            else if (key == "z")   _state.mp_z = parse_value<int32_t>(value);
-            else if (key == "pitch") _state.pitch = parse_value<int32_t>(value);
-            else if (key == "roll")  _state.roll = parse_value<int32_t>(value);
-            else if (key == "yaw")   _state.yaw = parse_value<int32_t>(value);
-            else if (key == "vgx")  _state.vgx = parse_value<int32_t>(value);
-            else if (key == "vgy")  _state.vgy = parse_value<int32_t>(value);
-            else if (key == "vgz")  _state.vgz = parse_value<int32_t>(value);
-            else if (key == "templ") _state.templ = parse_value<int32_t>(value);
-            else if (key == "temph") _state.temph = parse_value<int32_t>(value);
-            else if (key == "tof")   _state.height = parse_value<uint32_t>(value);
-            else if (key == "h")     _state.h = parse_value<uint32_t>(value);
-            else if (key == "bat")   _state.battery = parse_value<uint32_t>(value);
-            else if (key == "baro")  _state.sea_height = parse_value<float>(value);
-            else if (key == "time")  _state.time = parse_value<int32_t>(value);
-            else if (key == "agx")   _state.agx = parse_value<float>(value);
-            else if (key == "agy")   _state.agy = parse_value<float>(value);
-            else if (key == "agz")   _state.agz = parse_value<float>(value);
+        action = {};
+        action.command = str;
+        action.estimate = estimate;
+        action.active = true;
+        action.start = action.lastProgress = std::chrono::steady_clock::now();
+        action.startState = _state;
+        if (estimate.kind == ActionKind::Land)
+            action.estimate.amount = static_cast<float>(_state.h);
+    }
+
+    bool success = execute_command_raw(str, action_timeout(estimate), false, true);
+
+    std::lock_guard lock(stateMTX);
+    action.active = false;
+    action.end = std::chrono::steady_clock::now();
+    if (success) action.percent = 100.f;
+    return success;
+}
+
+TELLO_INLINE void Tello::update_action_progress() {
+    const auto now = std::chrono::steady_clock::now();
+    const bool firstPacket = action.lastTelemetry < action.start;
+    const float dt = firstPacket ? 0.f : std::chrono::duration<float>(now - action.lastTelemetry).count();
+    action.lastTelemetry = now;
+
+    switch (action.estimate.kind) {
+        case ActionKind::Linear: {
+            const float speed = TelloDefaults::TELEMETRY_VELOCITY_SCALE * std::hypot(_state.vgx, _state.vgy, _state.vgz);
+            action.travelled += speed * dt;
+            break;
+        }
+        case ActionKind::Vertical:
+            action.travelled = std::abs(static_cast<float>(_state.h) - static_cast<float>(action.startState.h));
+            break;
+        case ActionKind::Rotation: {
+            const int32_t previousYaw = firstPacket ? action.startState.yaw : action.lastYaw;
+            int32_t delta = (_state.yaw - previousYaw) % 360;
+            if (delta > 180) delta -= 360;
+            if (delta < -180) delta += 360;
+            action.travelled += static_cast<float>(std::abs(delta));
+            action.lastYaw = _state.yaw;
+            break;
         }
+        case ActionKind::Takeoff:
+            action.travelled = static_cast<float>(_state.h);
+            break;
+        case ActionKind::Land:
+            action.travelled = static_cast<float>(action.startState.h) - static_cast<float>(_state.h);
+            break;
+        case ActionKind::Timed:
+            return;
     }
 
-private:
-    SyncSocket commandServer;
-    AsyncSocket dataServer;
+    if (action.estimate.amount <= 0.f)
+        return;
 
-    bool connected = false;
+    const float percent = std::clamp(100.f * action.travelled / std::abs(action.estimate.amount), 0.f, 100.f);
+    if (percent >= action.percent + 1.f)
+        action.lastProgress = now;
+    action.percent = std::max(action.percent, percent);
+}
 
-    std::string ipAddress;
-    uint16_t commandPort = 0;
-    int commandTimeout = TelloDefaults::COMMAND_TIMEOUT_MS;
-    int actionTimeout = TelloDefaults::ACTION_TIMEOUT_MS;
+TELLO_INLINE std::optional<std::string> Tello::recv_action_response(std::string_view str, int timeout_ms, bool silent) {
+    using namespace std::chrono;
+    const auto deadline = steady_clock::now() + milliseconds(timeout_ms);
+    while (true) {
+        int slice = TelloDefaults::ACTION_POLL_MS;
+        if (timeout_ms > 0) {
+            auto remaining = duration_cast<milliseconds>(deadline - steady_clock::now()).count();
+            if (remaining <= 0) return std::nullopt;
+            slice = static_cast<int>(std::min<long long>(slice, remaining));
+        }
 
-    std::mutex requestMTX;
-    std::mutex stateMTX;
-    TelloState _state;
-};
+        if (auto response = transport->recv(slice))
+            return response;
+
+        bool stalled = false;
+        {
+            std::lock_guard lock(stateMTX);
+            stalled = action.stalled = action_stalled(steady_clock::now());
+            if (stalled && !silent) PRINTF_ERROR("[Tello] Action '{}' stalled at {:.0f}%", str, action.percent);
+        }
+        if (stalled) {
+            abandon_action(silent);
+            return std::nullopt;
+        }
+    }
+}
+
+TELLO_INLINE void Tello::abandon_action(bool silent) {
+    ++staleResponses;
+    if (transport->send(ipAddress, "stop"))
+        ++staleResponses;
+    else if (!silent)
+        PRINTF_ERROR("[Tello] Failed to send command 'stop': Socket error");
+
+    drain_stale_responses(commandTimeout);
+}
+
+TELLO_INLINE std::optional<std::string> Tello::send_request(std::string_view str, int timeout_ms, bool silent, bool isAction) {
+    if (!connected) {
+        if (!silent) PRINTF_ERROR("[Tello] Tello not connected");
+        return std::nullopt;
+    }
+
+    if (!silent) PRINTF_DEBUG("[Tello] DEBUG: Sending command '{}'", str);
+
+    std::unique_lock lock(requestMTX);
+    if (staleResponses > 0)
+        drain_stale_responses(1); // Whatever arrived by now, the response to this command cannot be among it
+
+    if (!transport->send(ipAddress, str)) {
+        if (!silent) PRINTF_ERROR("[Tello] Failed to send command '{}': Socket error", str);
+        return std::nullopt;
+    }
+
+    auto receive = [&] {
+        return isAction && adaptiveActionTimeout ? recv_action_response(str, timeout_ms, silent) : transport->recv(timeout_ms);
+    };
+
+    // The drone answers in order, so responses to abandoned actions that are still missing come first.
+    // Those are always 'ok' or 'error'; any other value is the response to this command, and the
+    // missing ones were lost.
+    auto response = receive();
+    while (response.has_value() && staleResponses > 0) {
+        if (*response != "ok" && !response->starts_with("error")) {
+            staleResponses = 0;
+            break;
+        }
+        --staleResponses;
+        response = receive();
+    }
+
+    if (!response.has_value()) {
+        if (!silent) PRINTF_ERROR("[Tello] Failed to send command '{}': Timeout waiting for response", str);
+        return std::nullopt;
+    }
+
+    return response;
+}
+
+TELLO_INLINE Tello::Tello(std::unique_ptr<Transport> transport) :
+    missionPadAPI(this),
+    transport(std::move(transport))
+{
+    this->transport->start_telemetry([this](auto data) { OnDataStream(data); });
+}
+
+TELLO_INLINE Tello::~Tello() {
+    if (connected) {
+        execute_action("land", true);
+        execute_command("streamoff", true);
+    }
+    transport.reset(); // Stop the telemetry before the state it writes to is destroyed
+}
+
+TELLO_INLINE Tello::UdpTransport::UdpTransport(const ThreadConfig& telemetryThread, uint16_t cmdPort, uint16_t dataPort, uint16_t locPort) :
+    UdpTransport(cmdPort, dataPort, locPort)
+{
+    const std::string defaultName = std::move(this->telemetryThread.name);
+    this->telemetryThread = telemetryThread;
+    if (this->telemetryThread.name.empty())
+        this->telemetryThread.name = defaultName;
+}
+
+TELLO_INLINE bool Tello::UdpTransport::send(std::string_view ip, std::string_view command) {
+    return commandSocket.send(ip, commandPort, command);
+}
+
+TELLO_INLINE std::optional<std::string> Tello::UdpTransport::recv(int timeout_ms) {
+    return commandSocket.recv(timeout_ms);
+}
+
+TELLO_INLINE void Tello::UdpTransport::start_telemetry(std::function<void(std::string_view)> callback) {
+    dataSocket = std::make_unique<AsyncSocket>(dataPort, std::move(callback), telemetryThread);
+}
+
+TELLO_INLINE bool Tello::UdpTransport::configure_threads(const ThreadConfig& config) {
+    return dataSocket && dataSocket->configure(config);
+}
+
+TELLO_INLINE std::vector<Tello::ThreadStats> Tello::UdpTransport::thread_stats() const {
+    if (!dataSocket) return {};
+    return { dataSocket->stats() };
+}
+
+#ifndef _WIN32
+TELLO_INLINE Tello::TelemetrySubscriber::TelemetrySubscriber(std::string_view name) : objectName(SharedTelemetry::object_name(name)) {
+    int fd = ::shm_open(objectName.c_str(), O_RDONLY, 0);
+    if (fd < 0) {
+        PRINTF_ERROR("TelemetrySubscriber::TelemetrySubscriber: shm_open('{}') failed.", objectName);
+        return;
+    }
+
+    struct stat st{};
+    if (::fstat(fd, &st) < 0 || static_cast<size_t>(st.st_size) < sizeof(SharedTelemetry::Header)) {
+        PRINTF_ERROR("TelemetrySubscriber::TelemetrySubscriber: '{}' is not a telemetry ring.", objectName);
+        ::close(fd);
+        return;
+    }
+
+    void* addr = ::mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (addr == MAP_FAILED) {
+        PRINTF_ERROR("TelemetrySubscriber::TelemetrySubscriber: mmap() failed.");
+        return;
+    }
+    mappedSize = st.st_size;
+    inode = st.st_ino;
+
+    const auto* hdr = static_cast<const SharedTelemetry::Header*>(addr);
+    if (hdr->magic != SharedTelemetry::MAGIC || hdr->version != SharedTelemetry::VERSION ||
+        hdr->rawCapacity != TelloDefaults::SHM_RAW_CAPACITY || hdr->slotCount == 0 ||
+        mappedSize < SharedTelemetry::size(hdr->slotCount)) {
+        PRINTF_ERROR("TelemetrySubscriber::TelemetrySubscriber: '{}' has an incompatible layout.", objectName);
+        ::munmap(addr, mappedSize);
+        return;
+    }
+
+    header = hdr;
+    slots = reinterpret_cast<const SharedTelemetry::Slot*>(static_cast<const char*>(addr) + sizeof(SharedTelemetry::Header));
+    slotCount = hdr->slotCount;
+}
+
+TELLO_INLINE bool Tello::TelemetrySubscriber::is_replaced() const {
+    if (!header) return false;
+    int fd = ::shm_open(objectName.c_str(), O_RDONLY, 0);
+    if (fd < 0) return true;
+    struct stat st{};
+    const bool same = ::fstat(fd, &st) == 0 && st.st_ino == inode;
+    ::close(fd);
+    return !same;
+}
+
+TELLO_INLINE std::optional<Tello::TelemetrySubscriber::Sample> Tello::TelemetrySubscriber::read(uint64_t index) const {
+    if (!header) return std::nullopt;
+
+    const auto& slot = slots[index % slotCount];
+    const uint64_t expected = 2 * index + 2;
+    Sample sample;
+    sample.index = index;
+
+    for (int attempt = 0; attempt < TelloDefaults::SHM_READ_RETRIES; ++attempt) {
+        const uint64_t before = slot.seq.load(std::memory_order_acquire);
+        if (before == expected - 1) { // The writer is in the middle of this very sample
+            std::this_thread::yield();
+            continue;
+        }
+        if (before != expected) return std::nullopt;
+
+        std::memcpy(&sample.state, &slot.state, sizeof(sample.state));
+        sample.rawSize = std::min<uint32_t>(slot.rawSize, TelloDefaults::SHM_RAW_CAPACITY);
+        std::memcpy(sample.rawData.data(), slot.raw, sample.rawSize);
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (slot.seq.load(std::memory_order_relaxed) == before)
+            return sample;
+    }
+    return std::nullopt;
+}
+
+TELLO_INLINE Tello::TelemetryPublisher::TelemetryPublisher(std::string_view name, bool includeRaw)
+: objectName(SharedTelemetry::object_name(name)), includeRaw(includeRaw) {
+    // Always start from a fresh object, a stale ring is only replaced if its publisher is gone
+    int fd = ::shm_open(objectName.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644);
+    if (fd < 0 && errno == EEXIST) {
+        if (const auto pid = live_publisher(objectName)) {
+            PRINTF_ERROR("TelemetryPublisher::TelemetryPublisher: '{}' is already published by process {}.", objectName, *pid);
+            return;
+        }
+        PRINTF_WARN("TelemetryPublisher::TelemetryPublisher: Replacing the stale ring '{}'.", objectName);
+        ::shm_unlink(objectName.c_str());
+        fd = ::shm_open(objectName.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644);
+    }
+    if (fd < 0) {
+        PRINTF_ERROR("TelemetryPublisher::TelemetryPublisher: shm_open('{}') failed.", objectName);
+        return;
+    }
+
+    const size_t size = SharedTelemetry::size(TelloDefaults::SHM_SLOT_COUNT);
+    if (::ftruncate(fd, static_cast<off_t>(size)) < 0) {
+        PRINTF_ERROR("TelemetryPublisher::TelemetryPublisher: ftruncate() failed.");
+        ::close(fd);
+        ::shm_unlink(objectName.c_str());
+        return;
+    }
+
+    void* addr = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (addr == MAP_FAILED) {
+        PRINTF_ERROR("TelemetryPublisher::TelemetryPublisher: mmap() failed.");
+        ::shm_unlink(objectName.c_str());
+        return;
+    }
+    mappedSize = size;
+
+    // The object is zero-filled by ftruncate(), the magic is written last to mark it as ready
+    header = static_cast<SharedTelemetry::Header*>(addr);
+    slots = reinterpret_cast<SharedTelemetry::Slot*>(static_cast<char*>(addr) + sizeof(SharedTelemetry::Header));
+    header->version = SharedTelemetry::VERSION;
+    header->slotCount = TelloDefaults::SHM_SLOT_COUNT;
+    header->rawCapacity = TelloDefaults::SHM_RAW_CAPACITY;
+    header->publisherPid = static_cast<int32_t>(::getpid());
+    std::atomic_thread_fence(std::memory_order_release);
+    header->magic = SharedTelemetry::MAGIC;
+}
+
+TELLO_INLINE std::optional<pid_t> Tello::TelemetryPublisher::live_publisher(const std::string& objectName) {
+    int fd = ::shm_open(objectName.c_str(), O_RDONLY, 0);
+    if (fd < 0) return std::nullopt;
+
+    std::optional<pid_t> pid;
+    struct stat st{};
+    if (::fstat(fd, &st) == 0 && static_cast<size_t>(st.st_size) >= sizeof(SharedTelemetry::Header)) {
+        void* addr = ::mmap(nullptr, sizeof(SharedTelemetry::Header), PROT_READ, MAP_SHARED, fd, 0);
+        if (addr != MAP_FAILED) {
+            const auto* hdr = static_cast<const SharedTelemetry::Header*>(addr);
+            if (hdr->magic == SharedTelemetry::MAGIC && hdr->version == SharedTelemetry::VERSION &&
+                hdr->closed.load(std::memory_order_acquire) == 0 &&
+                (::kill(hdr->publisherPid, 0) == 0 || errno == EPERM))
+                pid = hdr->publisherPid;
+            ::munmap(addr, sizeof(SharedTelemetry::Header));
+        }
+    }
+    ::close(fd);
+    return pid;
+}
+#endif
+
+#endif
 
 #endif // _TELLO_H
\ No newline at end of file
@@ -0,0 +1,16 @@
+
+#ifndef _TELLO_FWD_H
+#define _TELLO_FWD_H
+
+// Forward declarations of tello.h, for headers that only pass a Tello around by pointer or reference.
+// Including this instead of tello.h keeps <format>, the socket headers and the Tello class itself
+// out of the translation unit.
+
+class UDPsocket;
+class Tello;
+
+enum class LogColor;
+enum class FlipDirection : char;
+enum class MP_DetectDir;
+
+#endif // _TELLO_FWD_H
@@ -0,0 +1,81 @@
+// Stall detection of adaptive action deadlines over the loopback transport: an action that makes
+// no progress is abandoned with 'stop', and the late responses never reach the following commands.
+
+#include "tello.h"
+#include "check.h"
+
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+using namespace std::chrono;
+
+// Answers every command except 'forward', and reports a drone that does not move
+class StuckDrone {
+public:
+    enum class LateReply { Never, WithNextCommand };
+
+    StuckDrone(std::shared_ptr<Tello::LoopbackLink> link, LateReply lateReply)
+    : thread([this, link, lateReply](std::stop_token st) {
+        bool forwardPending = false;
+        while (!st.stop_requested() && !link->is_closed()) {
+            if (auto command = link->wait_command(20)) {
+                {
+                    std::lock_guard lock(mutex);
+                    commands.push_back(*command);
+                }
+                if (command->starts_with("forward")) {
+                    forwardPending = true;
+                    continue;
+                }
+                if (forwardPending && lateReply == LateReply::WithNextCommand && *command != "stop") {
+                    link->respond("ok"); // The late response to 'forward', just after the next command was sent
+                    forwardPending = false;
+                }
+                link->respond(*command == "battery?" ? "87" : "ok");
+            }
+            link->send_telemetry("vgx:0;vgy:0;vgz:0;h:80;tof:80;bat:87;");
+        }
+    }) {}
+
+    std::vector<std::string> received() {
+        std::lock_guard lock(mutex);
+        return commands;
+    }
+
+private:
+    std::mutex mutex;
+    std::vector<std::string> commands;
+    std::jthread thread; // Last, so it is joined before the members it uses are destroyed
+};
+
+void run(StuckDrone::LateReply lateReply) {
+    auto link = std::make_shared<Tello::LoopbackLink>();
+    StuckDrone drone(link, lateReply);
+    Tello tello(std::make_unique<Tello::LoopbackTransport>(link));
+
+    CHECK(tello.connect());
+    tello.set_command_timeout(300);
+    tello.set_adaptive_action_timeout(true);
+
+    const auto start = steady_clock::now();
+    CHECK(!tello.move_forward(100));
+    const auto elapsed = steady_clock::now() - start;
+    CHECK(elapsed >= milliseconds(TelloDefaults::ACTION_STALL_MS));
+    CHECK(elapsed < milliseconds(TelloDefaults::ACTION_STALL_MS + 2000));
+    CHECK(tello.action_progress().stalled);
+
+    const auto commands = drone.received();
+    CHECK(!commands.empty() && commands.back() == "stop");
+
+    // Neither the late response to 'forward' nor the one to 'stop' is taken for these
+    CHECK(tello.get_battery_level() == 87.f);
+    CHECK(tello.set_speed(30.f));
+    CHECK(tello.get_battery_level() == 87.f);
+}
+
+int main() {
+    run(StuckDrone::LateReply::Never);
+    run(StuckDrone::LateReply::WithNextCommand);
+    return test_result();
+}
@@ -0,0 +1,37 @@
+#ifndef _TELLO_TESTS_CHECK_H
+#define _TELLO_TESTS_CHECK_H
+
+// Minimal helpers for the tests, which are plain executables run by ctest:
+// every failed CHECK is printed and counted, main() returns test_result().
+
+#include <chrono>
+#include <cstdio>
+#include <thread>
+
+inline int checkFailures = 0;
+
+#define CHECK(condition) \
+    do { \
+        if (!(condition)) { \
+            ++checkFailures; \
+            std::printf("%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #condition); \
+        } \
+    } while (false)
+
+// Polls 'condition' until it holds or the timeout expires
+template<typename F>
+bool wait_until(F&& condition, int timeout_ms = 2000) {
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms);
+    while (!condition()) {
+        if (std::chrono::steady_clock::now() >= deadline) return false;
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return true;
+}
+
+inline int test_result() {
+    std::printf(checkFailures == 0 ? "All checks passed\n" : "%d checks failed\n", checkFailures);
+    return checkFailures == 0 ? 0 : 1;
+}
+
+#endif
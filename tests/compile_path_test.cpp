@@ -0,0 +1,123 @@
+// Table test for Tello::compile_path(): every path is compiled and the resulting commands are
+// compared with the expected ones, in the text the SDK would receive.
+
+#include "tello.h"
+
+#include <cmath>
+#include <cstdio>
+
+namespace {
+
+struct Case {
+    const char* name;
+    std::vector<Tello::Waypoint> path;
+    std::optional<std::vector<std::string>> expected; // Nothing if the path must be rejected
+    Tello::PathOptions options{};
+};
+
+std::string to_string(const Tello::PathStep& step) {
+    const auto& v = step.values;
+    switch (step.type) {
+        case Tello::PathStep::Type::Go:        return std::format("go {} {} {} {}", v[0], v[1], v[2], step.speed_cmps);
+        case Tello::PathStep::Type::Curve:     return std::format("curve {} {} {} {} {} {} {}", v[0], v[1], v[2], v[3], v[4], v[5], step.speed_cmps);
+        case Tello::PathStep::Type::TurnRight: return std::format("cw {}", v[0]);
+        case Tello::PathStep::Type::TurnLeft:  return std::format("ccw {}", v[0]);
+    }
+    return {};
+}
+
+// Points on a circle that is entered heading forward at (x, y) and curves to the left,
+// from 'from' to 'to' degrees in 'step' increments
+std::vector<Tello::Waypoint> arc(float x, float y, float radius, float from, float to, float step) {
+    std::vector<Tello::Waypoint> points;
+    for (float angle = from; angle <= to + 0.01f; angle += step) {
+        const float rad = angle * 3.14159265f / 180.f;
+        points.push_back({ x + radius * std::sin(rad), y + radius - radius * std::cos(rad), 0.f });
+    }
+    return points;
+}
+
+std::vector<Tello::Waypoint> concat(std::vector<Tello::Waypoint> a, const std::vector<Tello::Waypoint>& b) {
+    a.insert(a.end(), b.begin(), b.end());
+    return a;
+}
+
+} // namespace
+
+int main() {
+    using Strings = std::vector<std::string>;
+    const std::vector<Case> cases = {
+        { "collinear waypoints are merged",
+          { { 100, 0, 0 }, { 200, 0, 0 }, { 300, 0, 0 } },
+          Strings{ "go 300 0 0 50" } },
+        { "a corner is flown with two 'go', not a 'curve'",
+          { { 200, 0, 0 }, { 200, 200, 0 } },
+          Strings{ "go 200 0 0 50", "go 0 200 0 50" } },
+        { "three points on a circle are not enough for an arc",
+          { { 100, 100, 0 }, { 200, 0, 0 } },
+          Strings{ "go 100 100 0 50", "go 100 -100 0 50" } },
+        { "four points on a circle are flown as arcs",
+          concat({ { 200, 0, 0 } }, arc(200, 0, 100, 60, 180, 40)),
+          Strings{ "go 200 0 0 50", "curve 98 117 0 0 200 0 50" } },
+        { "a densely sampled arc is flown as a single 'curve'",
+          arc(0, 0, 200, 15, 90, 15),
+          Strings{ "curve 141 59 0 200 200 0 50" } },
+        { "a full circle takes two curves",
+          arc(0, 0, 100, 30, 360, 30),
+          Strings{ "curve 0 200 0 -50 13 0 50", "curve 24 -10 0 50 -13 0 50" } },
+        { "an arc beyond the SDK's range is split",
+          arc(0, 0, 400, 10, 180, 10),
+          Strings{ "curve 306 143 0 394 469 0 50", "curve -137 237 0 -394 331 0 50" } },
+        { "an explicitly marked arc",
+          { { .x = 100, .y = 100, .arc = true }, { 200, 0, 0 } },
+          Strings{ "curve 100 100 0 200 0 0 50" } },
+        { "no arcs when disabled",
+          { { .x = 100, .y = 100, .arc = true }, { 200, 0, 0 } },
+          Strings{ "go 100 100 0 50", "go 100 -100 0 50" }, { .allow_arcs = false } },
+        { "long legs are split",
+          { { 1200, 0, 0 } },
+          Strings{ "go 400 0 0 50", "go 400 0 0 50", "go 400 0 0 50" } },
+        { "a short leg is carried over to the next one",
+          { { 10, 0, 0 }, { 10, 100, 0 } },
+          Strings{ "go 10 100 0 50" } },
+        { "the SDK minimum of 20 cm is inclusive",
+          { { 20, 0, 0 } },
+          Strings{ "go 20 0 0 50" } },
+        { "a path that ends too short is rejected",
+          { { 15, 0, 0 } },
+          std::nullopt },
+        { "a final leg that ends too short is rejected",
+          { { 100, 0, 0, 90.f }, { 100, -15, 0 } },
+          std::nullopt },
+        { "headings turn after the waypoint, legs are in the body frame",
+          { { 100, 0, 0, 90.f }, { 100, -100, 0, -90.f } },
+          Strings{ "go 100 0 0 50", "cw 90", "go 100 0 0 50", "ccw 180" } },
+        { "speeds are clamped to the SDK limits",
+          { { .x = 100, .y = 100, .arc = true }, { 200, 0, 0 }, { 300, 0, 0 } },
+          Strings{ "curve 100 100 0 200 0 0 60", "go 100 0 0 100" }, { .speed_cmps = 200 } },
+    };
+
+    int failures = 0;
+    for (const auto& test : cases) {
+        const auto steps = Tello::compile_path(test.path, test.options);
+
+        std::optional<Strings> actual;
+        if (steps) {
+            actual.emplace();
+            for (const auto& step : *steps) actual->push_back(to_string(step));
+        }
+        if (actual == test.expected) continue;
+
+        ++failures;
+        auto join = [](const std::optional<Strings>& commands) {
+            if (!commands) return std::string("<rejected>");
+            std::string text;
+            for (const auto& command : *commands) text += (text.empty() ? "" : ", ") + command;
+            return text;
+        };
+        std::printf("FAILED: %s\n  expected: %s\n  actual:   %s\n", test.name, join(test.expected).c_str(), join(actual).c_str());
+    }
+
+    std::printf("%zu cases, %d failed\n", cases.size(), failures);
+    return failures == 0 ? 0 : 1;
+}
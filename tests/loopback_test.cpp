@@ -0,0 +1,85 @@
+// Drives a Tello through the in-process loopback transport: command round trips, timeouts,
+// telemetry parsing and closing the link while either end is waiting.
+
+#include "tello.h"
+#include "check.h"
+
+#include <atomic>
+
+using namespace std::chrono;
+
+int main() {
+    // Command round trip through a Tello
+    {
+        auto link = std::make_shared<Tello::LoopbackLink>();
+        std::jthread simulator([link](std::stop_token st) {
+            while (!st.stop_requested() && !link->is_closed()) {
+                if (auto command = link->wait_command(100))
+                    link->respond(*command == "battery?" ? "87" : "ok");
+            }
+        });
+
+        Tello tello(std::make_unique<Tello::LoopbackTransport>(link));
+        CHECK(tello.connect());
+        CHECK(tello.get_battery_level() == 87.f);
+        CHECK(tello.set_speed(30.f));
+
+        CHECK(link->send_telemetry("pitch:1;roll:-2;yaw:37;tof:112;h:110;bat:86;"));
+        const auto state = tello.state();
+        CHECK(state.pitch == 1 && state.roll == -2 && state.yaw == 37);
+        CHECK(state.height == 112 && state.h == 110 && state.battery == 86);
+    }
+
+    // The raw transport: commands arrive in order, an unanswered recv times out
+    {
+        auto link = std::make_shared<Tello::LoopbackLink>();
+        Tello::LoopbackTransport transport(link);
+
+        CHECK(transport.send("", "command"));
+        CHECK(transport.send("", "battery?"));
+        CHECK(link->poll_command() == "command");
+        CHECK(link->wait_command(10) == "battery?");
+        CHECK(!link->poll_command().has_value());
+        CHECK(!link->wait_command(10).has_value());
+
+        CHECK(link->respond("ok"));
+        CHECK(transport.recv(10) == "ok");
+
+        const auto start = steady_clock::now();
+        CHECK(!transport.recv(50).has_value());
+        CHECK(steady_clock::now() - start >= milliseconds(50));
+    }
+
+    // close() releases a recv that would wait forever and a pending wait_command()
+    {
+        auto link = std::make_shared<Tello::LoopbackLink>();
+        Tello::LoopbackTransport transport(link);
+
+        std::atomic<int> released{ 0 };
+        std::jthread tello([&] { if (!transport.recv(0)) ++released; });
+        std::jthread simulator([&] { if (!link->wait_command(0)) ++released; });
+
+        std::this_thread::sleep_for(milliseconds(50));
+        CHECK(released == 0);
+        link->close();
+        CHECK(wait_until([&] { return released == 2; }));
+
+        CHECK(link->is_closed());
+        CHECK(!transport.send("", "command"));
+        CHECK(!transport.recv(0).has_value());
+    }
+
+    // Destroying the transport closes the link, so the simulator stops waiting
+    {
+        auto link = std::make_shared<Tello::LoopbackLink>();
+        auto transport = std::make_unique<Tello::LoopbackTransport>(link);
+        std::atomic<bool> released{ false };
+        std::jthread simulator([&] { released = !link->wait_command(0).has_value(); });
+
+        transport.reset();
+        CHECK(wait_until([&] { return released.load(); }));
+        CHECK(!link->send_telemetry("bat:50;"));
+    }
+
+    return test_result();
+}
@@ -0,0 +1,82 @@
+// Feeds 'mid:' telemetry through the loopback transport and checks the pad events of
+// missionPadAPI and its queries, including a pad that goes stale after the telemetry stopped.
+
+#include "tello.h"
+#include "check.h"
+
+#include <mutex>
+#include <utility>
+#include <vector>
+
+using namespace std::chrono;
+
+int main() {
+    auto link = std::make_shared<Tello::LoopbackLink>();
+    Tello tello(std::make_unique<Tello::LoopbackTransport>(link));
+
+    std::mutex eventMTX;
+    std::vector<std::pair<Tello::PadEvent, int32_t>> events;
+    tello.missionPadAPI.on_pad_event([&](Tello::PadEvent event, const Tello::PadSighting& pad) {
+        std::lock_guard lock(eventMTX);
+        events.emplace_back(event, pad.id);
+    });
+    auto take_events = [&] {
+        std::lock_guard lock(eventMTX);
+        return std::exchange(events, {});
+    };
+    using Events = std::vector<std::pair<Tello::PadEvent, int32_t>>;
+    const auto lostTime = milliseconds(TelloDefaults::PAD_LOST_MS + 100);
+
+    CHECK(!tello.missionPadAPI.get_nearest_visible_pad().has_value());
+    CHECK(tello.missionPadAPI.get_pads().empty());
+
+    // Pad 3 comes into view, then pad 5 closer by; only the first sighting raises an event
+    link->send_telemetry("mid:3;x:100;y:-20;z:80;mpry:1,2,45;");
+    link->send_telemetry("mid:3;x:90;y:-20;z:80;mpry:1,2,45;");
+    CHECK((take_events() == Events{ { Tello::PadEvent::Acquired, 3 } }));
+
+    auto pad = tello.missionPadAPI.get_pad(3);
+    CHECK(pad && pad->visible && pad->x == 90 && pad->y == -20 && pad->z == 80 && pad->yaw == 45);
+
+    link->send_telemetry("mid:5;x:10;y:0;z:60;mpry:0,0,0;");
+    CHECK((take_events() == Events{ { Tello::PadEvent::Acquired, 5 } }));
+    auto nearest = tello.missionPadAPI.get_nearest_visible_pad();
+    CHECK(nearest && nearest->id == 5);
+
+    // Pad 3 is not reported anymore and is lost with the next packet after PAD_LOST_MS
+    std::this_thread::sleep_for(lostTime / 2);
+    link->send_telemetry("mid:5;x:10;y:0;z:60;mpry:0,0,0;");
+    std::this_thread::sleep_for(lostTime / 2);
+    link->send_telemetry("mid:5;x:12;y:0;z:60;mpry:0,0,0;");
+    CHECK((take_events() == Events{ { Tello::PadEvent::Lost, 3 } }));
+    pad = tello.missionPadAPI.get_pad(3);
+    CHECK(pad && !pad->visible && pad->yaw == 45); // The last pose is kept
+    CHECK(tello.missionPadAPI.get_pads().size() == 2);
+
+    // No pad in view: 'mid:-1' reports nothing
+    link->send_telemetry("mid:-1;x:-100;y:-100;z:-100;mpry:0,0,0;");
+    CHECK(take_events().empty());
+    nearest = tello.missionPadAPI.get_nearest_visible_pad();
+    CHECK(nearest && nearest->id == 5 && nearest->x == 12);
+
+    // The telemetry stops: no event can be raised, but the queries no longer report pad 5 as visible
+    std::this_thread::sleep_for(lostTime);
+    CHECK(!tello.missionPadAPI.get_nearest_visible_pad().has_value());
+    pad = tello.missionPadAPI.get_pad(5);
+    CHECK(pad && !pad->visible);
+    for (const auto& seen : tello.missionPadAPI.get_pads())
+        CHECK(!seen.visible);
+
+    // It is raised with the next packet, and the pad can be acquired again
+    link->send_telemetry("mid:-1;x:-100;y:-100;z:-100;mpry:0,0,0;");
+    CHECK((take_events() == Events{ { Tello::PadEvent::Lost, 5 } }));
+    link->send_telemetry("mid:5;x:10;y:0;z:60;mpry:0,0,0;");
+    CHECK((take_events() == Events{ { Tello::PadEvent::Acquired, 5 } }));
+
+    // Out-of-range pad IDs are ignored
+    link->send_telemetry("mid:9;x:10;y:0;z:60;mpry:0,0,0;");
+    CHECK(take_events().empty());
+    CHECK(!tello.missionPadAPI.get_pad(9).has_value());
+
+    return test_result();
+}
@@ -0,0 +1,11 @@
+// Checks that the 'tello' module can be imported and used, built with -DTELLO_BUILD_MODULE=ON
+
+import tello;
+
+int main() {
+    static_assert(TelloDefaults::COMMAND_PORT == 8889);
+
+    const Tello::Waypoint path[] = { { 100, 0, 0 } };
+    const auto steps = Tello::compile_path(path);
+    return steps && steps->size() == 1 ? 0 : 1;
+}
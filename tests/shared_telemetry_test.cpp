@@ -0,0 +1,79 @@
+// Publishes telemetry into a shared-memory ring through a loopback Tello and reads it back
+// with TelemetrySubscriber, including a subscriber that falls behind by more than one ring.
+
+#include "tello.h"
+#include "check.h"
+
+int main() {
+    const std::string name = std::format("tello_shared_telemetry_test_{}", ::getpid());
+    constexpr uint64_t slotCount = TelloDefaults::SHM_SLOT_COUNT;
+
+    auto link = std::make_shared<Tello::LoopbackLink>();
+    auto tello = std::make_unique<Tello>(std::make_unique<Tello::LoopbackTransport>(link));
+    CHECK(tello->enable_shared_telemetry(name, true));
+
+    Tello::TelemetrySubscriber subscriber(name);
+    CHECK(subscriber.is_open());
+    CHECK(!subscriber.is_closed());
+    CHECK(!subscriber.latest().has_value());
+
+    // Round trip of a single packet
+    CHECK(link->send_telemetry("bat:87;h:110;yaw:-37;"));
+    auto sample = subscriber.poll();
+    CHECK(sample.has_value());
+    if (sample) {
+        CHECK(sample->index == 0);
+        CHECK(sample->state.battery == 87);
+        CHECK(sample->state.yaw == -37);
+        CHECK(sample->raw() == "bat:87;h:110;yaw:-37;");
+    }
+    CHECK(!subscriber.poll().has_value());
+
+    // Falling more than one ring behind skips ahead to the oldest sample still available
+    for (uint64_t i = 1; i <= 3 * slotCount; ++i)
+        link->send_telemetry(std::format("bat:{};", i % 100));
+    const uint64_t published = subscriber.published();
+    CHECK(published == 3 * slotCount + 1);
+
+    uint64_t expected = published - slotCount, received = 0;
+    while (auto next = subscriber.poll()) {
+        CHECK(next->index == expected);
+        CHECK(next->state.battery == expected % 100);
+        ++expected;
+        ++received;
+    }
+    CHECK(received == slotCount);
+
+    auto latest = subscriber.latest();
+    CHECK(latest.has_value() && latest->index == published - 1);
+    CHECK(!subscriber.read(0).has_value()); // Long overwritten
+
+    // A live ring is never taken over by another publisher
+    {
+        auto otherLink = std::make_shared<Tello::LoopbackLink>();
+        Tello other(std::make_unique<Tello::LoopbackTransport>(otherLink));
+        CHECK(!other.enable_shared_telemetry(name));
+    }
+    CHECK(!subscriber.is_closed());
+    CHECK(!subscriber.is_replaced());
+
+    // Closing is visible to the subscriber, a new ring under the same name is detected
+    tello->disable_shared_telemetry();
+    CHECK(subscriber.is_closed());
+    CHECK(subscriber.is_replaced());
+    CHECK(subscriber.latest().has_value()); // The samples stay readable
+
+    CHECK(tello->enable_shared_telemetry(name));
+    CHECK(subscriber.is_replaced());
+    link->send_telemetry("bat:42;");
+
+    Tello::TelemetrySubscriber reopened(name);
+    CHECK(!reopened.is_closed());
+    auto fresh = reopened.latest();
+    CHECK(fresh.has_value() && fresh->index == 0 && fresh->state.battery == 42);
+
+    tello.reset();
+    CHECK(reopened.is_closed());
+
+    return test_result();
+}